@@ -106,7 +106,7 @@ if "%cmake%"=="1"   (
 
 :: Compile/Link Line Definitions
 :: ----------------------------------------------------------------------------
-set cc_common=   -I"raylib\include" -I"%source_dir%\include" -Wall -std=c99 -D_DEFAULT_SOURCE -Wno-missing-braces -Wunused-result -Wextra -Wmissing-prototypes -Wstrict-prototypes -Wfloat-conversion
+set cc_common=   -I"raylib\include" -I"%source_dir%\include" -Wall -std=c99 -D_DEFAULT_SOURCE -Wno-missing-braces -Wunused-result -Wextra -Wmissing-prototypes -Wstrict-prototypes -Wfloat-conversion -ffp-contract=off
 set cc_debug=    -g -O0
 set cc_release=  -O2
 set cc_platform= -DPLATFORM_DESKTOP
@@ -107,7 +107,7 @@ script_choose_cmake_lines()
 script_choose_simple_lines()
 {
     # Line Definitions
-    cc_common="-I\"raylib/include\" -I\"${source_dir}/include\" -Wall -std=c99 -D_DEFAULT_SOURCE -Wno-missing-braces -Wunused-result -Wextra -Wmissing-prototypes -Wstrict-prototypes -Wfloat-conversion"
+    cc_common="-I\"raylib/include\" -I\"${source_dir}/include\" -Wall -std=c99 -D_DEFAULT_SOURCE -Wno-missing-braces -Wunused-result -Wextra -Wmissing-prototypes -Wstrict-prototypes -Wfloat-conversion -ffp-contract=off"
     cc_debug='-g -O0'
     cc_release='-O2'
     cc_platform='-DPLATFORM_DESKTOP'
@@ -0,0 +1,392 @@
+// EXPLANATION:
+// Loading, playing and freeing of sounds and textures
+// See assets.h for more documentation/descriptions
+
+#if !defined(_WIN32) && !defined(__APPLE__) && !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE 200112L // for mmap with -std=c99
+#endif
+
+#include "assets.h"
+
+#include <stddef.h> // for NULL
+#include <string.h> // for memcmp, strcmp, memchr
+
+#include "atomics.h"
+#include "jobs.h"
+#include "assetpack.h"
+
+#if defined(PLATFORM_WEB)
+    // No mmap, the pack is read from the preloaded file system instead
+#elif defined(_WIN32)
+    // windows.h clashes with raylib.h, so only declare what's needed
+    __declspec(dllimport) void *__stdcall CreateFileA(const char *fileName, unsigned long access, unsigned long shareMode,
+                                                      void *security, unsigned long creation, unsigned long flags, void *templateFile);
+    __declspec(dllimport) int __stdcall GetFileSizeEx(void *file, long long *size);
+    __declspec(dllimport) void *__stdcall CreateFileMappingA(void *file, void *security, unsigned long protect,
+                                                             unsigned long sizeHigh, unsigned long sizeLow, const char *name);
+    __declspec(dllimport) void *__stdcall MapViewOfFile(void *mapping, unsigned long access, unsigned long offsetHigh,
+                                                        unsigned long offsetLow, size_t size);
+    __declspec(dllimport) int __stdcall UnmapViewOfFile(const void *address);
+    __declspec(dllimport) int __stdcall CloseHandle(void *handle);
+#else
+    #include <fcntl.h>    // for open
+    #include <sys/mman.h> // for mmap
+    #include <sys/stat.h> // for fstat
+    #include <unistd.h>   // for close
+#endif
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+typedef enum AssetType {
+    ASSET_TEXTURE,
+    ASSET_SOUND,
+} AssetType;
+
+typedef struct AssetRequest {
+    AssetType type;
+    const char *fileName;
+    void *destination; // the Texture or Sound to fill in when uploaded
+    Image image; // decoded, waiting for upload
+    Wave wave;
+    bool isPacked; // image or wave point into the pack, there's nothing to decode or free
+} AssetRequest;
+
+// Requests are decoded and uploaded in the order they were queued
+typedef struct AssetLoader {
+    AssetRequest requests[ASSET_QUEUE_MAX];
+    unsigned int count;
+    unsigned int decodedCount; // atomic, written by the thread decoding
+    unsigned int uploadedCount;
+    bool isStarted; // the list can't change after this
+    bool isThreaded;
+} AssetLoader;
+
+// The pack file, mapped while its assets are uploaded
+typedef struct AssetPack {
+    unsigned char *data; // read only
+    unsigned int size;
+    const AssetPackEntry *entries;
+    unsigned int entryCount;
+} AssetPack;
+
+// Globals
+// ----------------------------------------------------------------------------
+static AssetLoader loader = { 0 };
+static AssetPack pack = { 0 };
+
+// Asset Pack
+// ----------------------------------------------------------------------------
+#if defined(PLATFORM_WEB)
+static unsigned char *MapAssetPackFile(const char *fileName, unsigned int *size)
+{
+    int fileSize = 0;
+    unsigned char *data = LoadFileData(fileName, &fileSize);
+    *size = (unsigned int)fileSize;
+    return data;
+}
+
+static void UnmapAssetPackFile(unsigned char *data, unsigned int size)
+{
+    (void)size;
+    UnloadFileData(data);
+}
+#elif defined(_WIN32)
+static unsigned char *MapAssetPackFile(const char *fileName, unsigned int *size)
+{
+    void *file = CreateFileA(fileName, 0x80000000, 0x1, NULL, 3, 0x80, NULL); // GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL
+    if (file == (void *)-1) // INVALID_HANDLE_VALUE
+        return NULL;
+
+    long long fileSize = 0;
+    void *mapping = NULL;
+    if (GetFileSizeEx(file, &fileSize) && (fileSize > 0) && (fileSize <= 0xFFFFFFFF))
+        mapping = CreateFileMappingA(file, NULL, 0x02, 0, 0, NULL); // PAGE_READONLY
+    unsigned char *data = (mapping != NULL)? MapViewOfFile(mapping, 0x4, 0, 0, 0) : NULL; // FILE_MAP_READ
+
+    // The view keeps the file open
+    if (mapping != NULL) CloseHandle(mapping);
+    CloseHandle(file);
+    *size = (unsigned int)fileSize;
+    return data;
+}
+
+static void UnmapAssetPackFile(unsigned char *data, unsigned int size)
+{
+    (void)size;
+    UnmapViewOfFile(data);
+}
+#else
+static unsigned char *MapAssetPackFile(const char *fileName, unsigned int *size)
+{
+    int file = open(fileName, O_RDONLY);
+    if (file < 0)
+        return NULL;
+
+    struct stat info;
+    void *data = MAP_FAILED;
+    if ((fstat(file, &info) == 0) && (info.st_size > 0) && (info.st_size <= 0xFFFFFFFF))
+        data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+    // The mapping keeps the file open
+    close(file);
+    if (data == MAP_FAILED)
+        return NULL;
+    *size = (unsigned int)info.st_size;
+    return data;
+}
+
+static void UnmapAssetPackFile(unsigned char *data, unsigned int size)
+{
+    munmap(data, size);
+}
+#endif
+
+static bool IsAssetPackEntryValid(const AssetPackEntry *entry)
+{
+    unsigned long long expectedSize = 0;
+    if (entry->type == ASSET_PACK_TEXTURE)
+        expectedSize = (unsigned long long)entry->width*entry->height*4;
+    else if (entry->type == ASSET_PACK_SOUND)
+        expectedSize = (unsigned long long)entry->frameCount*ASSET_PACK_CHANNELS*ASSET_PACK_SAMPLE_SIZE/8;
+
+    return (memchr(entry->fileName, '\0', ASSET_PACK_NAME_SIZE) != NULL) &&
+           (entry->size == expectedSize) && (entry->offset % ASSET_PACK_ALIGNMENT == 0) &&
+           (entry->offset <= pack.size) && (entry->size <= pack.size - entry->offset);
+}
+
+static void CloseAssetPack(void)
+{
+    if (pack.data != NULL)
+        UnmapAssetPackFile(pack.data, pack.size);
+    pack = (AssetPack){ 0 };
+}
+
+// Map the pack and check it's one this version can read, false if there's
+// no (usable) pack
+static bool OpenAssetPack(void)
+{
+    if (pack.data != NULL)
+        return true;
+    if (!FileExists(ASSET_PACK_FILE))
+        return false;
+
+    pack.data = MapAssetPackFile(ASSET_PACK_FILE, &pack.size);
+    if (pack.data == NULL)
+    {
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Failed to map pack, loading asset files instead", ASSET_PACK_FILE);
+        pack = (AssetPack){ 0 };
+        return false;
+    }
+
+    const AssetPackHeader *header = (const AssetPackHeader *)pack.data;
+    bool isValid = (pack.size >= sizeof(AssetPackHeader)) &&
+                   (memcmp(header->magic, ASSET_PACK_MAGIC, sizeof(header->magic)) == 0) &&
+                   (header->version == ASSET_PACK_VERSION) &&
+                   (header->entryCount <= (pack.size - sizeof(AssetPackHeader))/sizeof(AssetPackEntry));
+    if (isValid)
+    {
+        pack.entries = (const AssetPackEntry *)(pack.data + sizeof(AssetPackHeader));
+        pack.entryCount = header->entryCount;
+        for (unsigned int i = 0; isValid && (i < pack.entryCount); i++)
+            isValid = IsAssetPackEntryValid(&pack.entries[i]);
+    }
+
+    if (!isValid)
+    {
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Not a pack from this version of the game, loading asset files instead", ASSET_PACK_FILE);
+        CloseAssetPack();
+    }
+
+    return isValid;
+}
+
+// Point the request at its data in the pack, false if it isn't packed
+static bool FindPackedAsset(AssetRequest *request)
+{
+    for (unsigned int i = 0; i < pack.entryCount; i++)
+    {
+        const AssetPackEntry *entry = &pack.entries[i];
+        if (strcmp(entry->fileName, request->fileName) != 0)
+            continue;
+
+        // raylib only reads the data when creating textures and sounds
+        void *data = pack.data + entry->offset;
+        if ((request->type == ASSET_TEXTURE) && (entry->type == ASSET_PACK_TEXTURE))
+        {
+            request->image = (Image){ .data = data, .width = (int)entry->width, .height = (int)entry->height,
+                                      .mipmaps = 1, .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+            request->isPacked = true;
+        }
+        else if ((request->type == ASSET_SOUND) && (entry->type == ASSET_PACK_SOUND))
+        {
+            request->wave = (Wave){ .frameCount = entry->frameCount, .sampleRate = ASSET_PACK_SAMPLE_RATE,
+                                    .sampleSize = ASSET_PACK_SAMPLE_SIZE, .channels = ASSET_PACK_CHANNELS, .data = data };
+            request->isPacked = true;
+        }
+        return request->isPacked;
+    }
+
+    return false;
+}
+
+// Local Functions
+// ----------------------------------------------------------------------------
+static void QueueAsset(AssetType type, void *destination, const char *fileName)
+{
+    // A new batch, after the last one is all loaded
+    if (loader.isStarted)
+    {
+        FinishAssetLoading();
+        loader = (AssetLoader){ 0 };
+    }
+
+    if (loader.count == ASSET_QUEUE_MAX)
+    {
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Too many assets queued, not loaded", fileName);
+        return;
+    }
+
+    loader.requests[loader.count++] = (AssetRequest){ .type = type, .fileName = fileName, .destination = destination };
+}
+
+// Read and decode the file, doesn't need the main thread
+static void DecodeNextAsset(void)
+{
+    unsigned int requestIdx = AtomicLoad(&loader.decodedCount);
+    AssetRequest *request = &loader.requests[requestIdx];
+    if (!request->isPacked) // packed ones are already decoded
+    {
+        if (request->type == ASSET_TEXTURE)
+            request->image = LoadImage(request->fileName);
+        else
+            request->wave = LoadWave(request->fileName);
+    }
+
+    AtomicStore(&loader.decodedCount, requestIdx + 1); // ready for upload
+}
+
+// Background thread
+static void DecodeAssets(void *data)
+{
+    (void)data;
+    while (AtomicLoad(&loader.decodedCount) < loader.count)
+        DecodeNextAsset();
+}
+
+// Create the texture or sound from the decoded data, on the main thread
+static void UploadNextAsset(void)
+{
+    AssetRequest *request = &loader.requests[loader.uploadedCount++];
+    if (request->type == ASSET_TEXTURE)
+    {
+        if (IsImageValid(request->image))
+            *(Texture *)request->destination = LoadTextureFromImage(request->image);
+        if (!request->isPacked)
+            UnloadImage(request->image);
+    }
+    else
+    {
+        if (IsWaveValid(request->wave))
+            *(Sound *)request->destination = LoadSoundFromWave(request->wave);
+        if (!request->isPacked)
+            UnloadWave(request->wave);
+    }
+
+    // Textures and sounds have their own copies now
+    if (loader.uploadedCount == loader.count)
+        CloseAssetPack();
+}
+
+// Loading
+// ----------------------------------------------------------------------------
+
+// Without a window or audio device (e.g. the benchmark), assets are left empty
+// instead of loading, and empty assets are skipped when unloading
+
+void QueueGameTexture(Texture *texture, const char *fileName)
+{
+    *texture = (Texture){ 0 };
+    if (IsWindowReady())
+        QueueAsset(ASSET_TEXTURE, texture, fileName);
+}
+
+void QueueGameSound(Sound *sound, const char *fileName)
+{
+    *sound = (Sound){ 0 };
+    if (IsAudioDeviceReady())
+        QueueAsset(ASSET_SOUND, sound, fileName);
+}
+
+void StartAssetLoading(void)
+{
+    if (loader.isStarted)
+        return;
+
+    loader.isStarted = true;
+
+    // Packed assets need no decoding, a thread is only worth it for the files
+    bool hasFiles = false;
+    bool hasPack = (loader.count > 0) && OpenAssetPack();
+    for (unsigned int i = 0; i < loader.count; i++)
+    {
+        if (!hasPack || !FindPackedAsset(&loader.requests[i]))
+            hasFiles = true;
+    }
+    if (hasPack && hasFiles)
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Some assets aren't in the pack, loading their files", ASSET_PACK_FILE);
+
+    loader.isThreaded = hasFiles && StartBackgroundThread(DecodeAssets, NULL);
+}
+
+void UpdateAssetLoading(void)
+{
+    if (!loader.isStarted)
+        return;
+
+    // Without a thread, decode here, only as many as get uploaded this frame
+    while (!loader.isThreaded && (AtomicLoad(&loader.decodedCount) < loader.count) &&
+           (AtomicLoad(&loader.decodedCount) < loader.uploadedCount + ASSET_UPLOADS_PER_FRAME))
+        DecodeNextAsset();
+
+    unsigned int decodedCount = AtomicLoad(&loader.decodedCount);
+    for (unsigned int i = 0; (i < ASSET_UPLOADS_PER_FRAME) && (loader.uploadedCount < decodedCount); i++)
+        UploadNextAsset();
+}
+
+void FinishAssetLoading(void)
+{
+    StartAssetLoading(); // if nothing started it (e.g. the benchmark)
+
+    if (loader.isThreaded)
+    {
+        WaitBackgroundThread(); // everything is decoded once it returns
+        loader.isThreaded = false;
+    }
+    while (AtomicLoad(&loader.decodedCount) < loader.count)
+        DecodeNextAsset();
+    while (loader.uploadedCount < loader.count)
+        UploadNextAsset();
+}
+
+bool IsAssetLoadingDone(void)
+{
+    return (loader.uploadedCount == loader.count);
+}
+
+// Playing & Freeing
+// ----------------------------------------------------------------------------
+void UnloadGameTexture(Texture texture)
+{
+    if (texture.id > 0)
+        UnloadTexture(texture);
+}
+
+void UnloadGameSound(Sound sound)
+{
+    UnloadSound(sound);
+}
+
+void PlayGameSound(Sound sound)
+{
+    PlaySound(sound);
+}
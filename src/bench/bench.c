@@ -0,0 +1,388 @@
+// EXPLANATION:
+// Entry point for the benchmark build, times the game loop in named scenarios
+// and prints the results as JSON, so changes to game code can be compared
+// - Every scenario starts from the same seed and runs UpdateGameFrame() for a
+//   fixed number of ticks, optionally followed by DrawGameFrame() in a hidden window
+// - Without --draw there is no window or audio device, assets stay empty
+// - With --draw, each scenario also reports its average draw calls, batch
+//   flushes, vertices and texture changes per frame
+// - --check draws too, and fails when a scenario's draw calls or batch flushes
+//   differ from the expected counts in the scenario table (default ticks and seed only)
+// - Each scenario ends by timing a save and restore of the game state
+//
+// Usage: asteroids_bench [--ticks N] [--seed S] [--workers W] [--draw] [--check] [--scenario NAME]
+// Worker threads default to one less than the number of cores, 0 runs everything on one thread
+
+#include <stdio.h>  // for printf
+#include <stdlib.h> // for qsort, strtoul
+#include <string.h> // for strcmp
+
+#include "raylib.h"
+
+#include "config.h"
+#include "input.h"
+#include "ui.h"
+#include "game.h"
+#include "profiler.h" // for GetProfilerTime(), works without a window
+#include "jobs.h"
+#include "render.h"
+#include "drawstats.h"
+#include "assets.h" // for FinishAssetLoading()
+
+#define BENCH_DEFAULT_TICKS 2000
+#define BENCH_DEFAULT_SEED 1
+#define BENCH_SNAPSHOT_REPEATS 100 // saves and restores, averaged
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+typedef struct BenchScenario {
+    const char *name;
+    void (*Setup)(void); // build the starting game state
+    bool rapidFire; // shoot every tick instead of at the auto fire rate
+    unsigned int volley; // more missiles fired all around the ship every tick
+    unsigned int drawCalls; // expected, summed over every frame with the default ticks and seed
+    unsigned int batchFlushes; // same
+} BenchScenario;
+
+typedef struct BenchStats {
+    double mean, p50, p99, max; // microseconds
+} BenchStats;
+
+// Globals
+// ----------------------------------------------------------------------------
+GameState  game;
+GameAssets assets;
+GameWorld  world;
+InputState input;
+UiState    ui;
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+static void SetupLevel1(void);
+static void SetupLevel30(void);
+static void Setup10kRocks(void);
+static void Setup100kRocks(void);
+static void SetupMissileFire(void);
+static void SetupMissileStorm(void);
+static void SetupScreenEdges(void);
+static void CreateRocks(unsigned int count); // Fill the world with random rocks of every size
+static void SetBenchInput(unsigned int tick, const BenchScenario *scenario); // Turn, thrust and shoot on a fixed pattern
+static void KeepShipAlive(void); // Undo a ship hit, so the ship keeps flying (and colliding) where it was
+static int CompareDoubles(const void *a, const void *b);
+static BenchStats GetBenchStats(double *samples, unsigned int count); // Sorts samples
+static void PrintBenchStats(const char *name, BenchStats stats, bool lastField);
+
+// Scenarios
+// ----------------------------------------------------------------------------
+// Expected draw counts only change with what's drawn (see drawstats.h), when a
+// change to drawing is on purpose, copy the new counts from the --check errors
+static const BenchScenario scenarios[] = {
+    { "level_1",       SetupLevel1,       false, 0,  17061, 4000 },
+    { "level_30",      SetupLevel30,      false, 0,  20884, 4000 },
+    { "rocks_10k",     Setup10kRocks,     false, 0,  20553, 4000 },
+    { "rocks_100k",    Setup100kRocks,    false, 0,  36556, 20000 },
+    { "missile_fire",  SetupMissileFire,  true,  0,  21912, 4000 },
+    { "missile_storm", SetupMissileStorm, true,  40, 30507, 15827 }, // about 6000 missiles live at once
+    { "screen_edges",  SetupScreenEdges,  false, 0,  20957, 4000 },
+};
+#define BENCH_SCENARIO_COUNT (sizeof(scenarios)/sizeof(scenarios[0]))
+
+// Main entry point
+// ----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    unsigned int tickCount = BENCH_DEFAULT_TICKS;
+    unsigned int seed = BENCH_DEFAULT_SEED;
+    unsigned int workerCount = GetProcessorCount() - 1;
+    bool draw = false;
+    bool check = false;
+    const char *onlyScenario = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--ticks") && (i + 1 < argc)) tickCount = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--seed") && (i + 1 < argc)) seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--workers") && (i + 1 < argc)) workerCount = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--scenario") && (i + 1 < argc)) onlyScenario = argv[++i];
+        else if (!strcmp(argv[i], "--draw")) draw = true;
+        else if (!strcmp(argv[i], "--check")) draw = check = true;
+        else
+        {
+            fprintf(stderr, "Usage: %s [--ticks N] [--seed S] [--workers W] [--draw] [--check] [--scenario NAME]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (tickCount == 0) tickCount = 1;
+    if (check && ((tickCount != BENCH_DEFAULT_TICKS) || (seed != BENCH_DEFAULT_SEED)))
+    {
+        fprintf(stderr, "--check only has expected counts for the default --ticks and --seed\n");
+        return 1;
+    }
+
+    // Initialization
+    // ----------------------------------------------------------------------------
+    SetTraceLogLevel(LOG_WARNING);
+    InitJobSystem(workerCount);
+    if (draw)
+    {
+        SetConfigFlags(FLAG_WINDOW_HIDDEN); // no vsync, so drawing isn't throttled
+        InitWindow(INITIAL_WIDTH, INITIAL_HEIGHT, WINDOW_TITLE);
+        InitRenderQueue();
+    }
+    InitUiState();
+    InitGameState(SCREEN_GAMEPLAY); // queues assets (if there's a window)
+    FinishAssetLoading(); // all of it now, so loading doesn't show in the timings
+
+    double *updateSamples = MemAlloc(tickCount*sizeof(double));
+    double *drawSamples = MemAlloc(tickCount*sizeof(double));
+    GameSnapshot snapshot = { 0 };
+
+    // Run scenarios
+    // ----------------------------------------------------------------------------
+    printf("{\n");
+    printf("  \"ticks\": %u,\n", tickCount);
+    printf("  \"seed\": %u,\n", seed);
+    printf("  \"workers\": %u,\n", GetJobWorkerCount());
+    printf("  \"draw\": %s,\n", draw? "true" : "false");
+    printf("  \"scenarios\": [");
+
+    bool firstScenario = true;
+    unsigned int failedChecks = 0;
+    for (unsigned int s = 0; s < BENCH_SCENARIO_COUNT; s++)
+    {
+        const BenchScenario *scenario = &scenarios[s];
+        if ((onlyScenario != NULL) && strcmp(onlyScenario, scenario->name))
+            continue;
+
+        // Same starting point for every scenario
+        SetGameSeed(seed);
+        InitGameState(SCREEN_GAMEPLAY);
+        InitDefaultInputSettings();
+        game.camera.zoom = (float)INITIAL_WIDTH/VIRTUAL_WIDTH;
+        game.camera.offset = (Vector2){ INITIAL_WIDTH/2.0f, INITIAL_HEIGHT/2.0f };
+        scenario->Setup();
+        game.newLevelTimer = 0; // skip the new level message, nothing moves while it shows
+        game.ship.safeRespawnTimer = 0; // collide with rocks from the first tick
+        unsigned int rocksStart = game.rockCount;
+        double drawCalls = 0, batchFlushes = 0, vertices = 0, textureChanges = 0; // summed over frames
+
+        for (unsigned int tick = 0; tick < tickCount; tick++)
+        {
+            SetBenchInput(tick, scenario);
+            game.frameTime = TICK_TIME;
+
+            double startTime = GetProfilerTime();
+            UpdateGameFrame();
+            ConsumeUserInput();
+            double updateTime = GetProfilerTime();
+            updateSamples[tick] = (updateTime - startTime)*1e6;
+            KeepShipAlive(); // so the load stays the same
+
+            if (draw)
+            {
+                UpdateStarfield(INITIAL_WIDTH, INITIAL_HEIGHT);
+                BeginDrawing();
+                BeginDrawStatsFrame();
+                ClearBackground(BLACK);
+                BeginMode2D(game.camera);
+                DrawGameFrame();
+                EndMode2D();
+                EndDrawing();
+                EndDrawStatsFrame(SCREEN_GAMEPLAY);
+                drawSamples[tick] = (GetProfilerTime() - updateTime)*1e6;
+
+                DrawStats frameStats = GetDrawStats();
+                drawCalls += frameStats.drawCalls;
+                batchFlushes += frameStats.batchFlushes;
+                vertices += frameStats.vertices;
+                textureChanges += frameStats.textureChanges;
+            }
+        }
+
+        // After the first save, a snapshot only allocates when the pool grows
+        SaveGameSnapshot(&snapshot);
+        double saveStart = GetProfilerTime();
+        for (unsigned int i = 0; i < BENCH_SNAPSHOT_REPEATS; i++)
+            SaveGameSnapshot(&snapshot);
+        double restoreStart = GetProfilerTime();
+        for (unsigned int i = 0; i < BENCH_SNAPSHOT_REPEATS; i++)
+            RestoreGameSnapshot(&snapshot);
+        double restoreEnd = GetProfilerTime();
+
+        printf("%s\n    {\n", firstScenario? "" : ",");
+        printf("      \"name\": \"%s\",\n", scenario->name);
+        printf("      \"rocks_start\": %u,\n", rocksStart);
+        printf("      \"rocks_end\": %u,\n", game.rockCount);
+        printf("      \"snapshot_us\": { \"save\": %.3f, \"restore\": %.3f },\n",
+               (restoreStart - saveStart)*1e6/BENCH_SNAPSHOT_REPEATS, (restoreEnd - restoreStart)*1e6/BENCH_SNAPSHOT_REPEATS);
+        PrintBenchStats("update_us", GetBenchStats(updateSamples, tickCount), !draw);
+        if (draw)
+        {
+            PrintBenchStats("draw_us", GetBenchStats(drawSamples, tickCount), false);
+            printf("      \"draw_stats\": { \"draw_calls\": %.1f, \"batch_flushes\": %.1f, \"vertices\": %.1f, \"texture_changes\": %.1f }\n",
+                   drawCalls/tickCount, batchFlushes/tickCount, vertices/tickCount, textureChanges/tickCount);
+        }
+        printf("    }");
+        firstScenario = false;
+
+        // Totals are whole numbers, so a double holds them exactly
+        if (check && (((unsigned int)drawCalls != scenario->drawCalls) || ((unsigned int)batchFlushes != scenario->batchFlushes)))
+        {
+            fprintf(stderr, "%s: %u draw calls and %u batch flushes, expected %u and %u\n", scenario->name,
+                    (unsigned int)drawCalls, (unsigned int)batchFlushes, scenario->drawCalls, scenario->batchFlushes);
+            failedChecks++;
+        }
+    }
+    printf("\n  ]\n}\n");
+
+    // De-Initialization
+    // ----------------------------------------------------------------------------
+    MemFree(updateSamples);
+    MemFree(drawSamples);
+    FreeGameSnapshot(&snapshot);
+    FreeGameState();
+    FreeUiState();
+    FreeJobSystem();
+    FreeRenderQueue();
+    if (draw) CloseWindow();
+
+    if (firstScenario && (onlyScenario != NULL))
+    {
+        fprintf(stderr, "No scenario named \"%s\"\n", onlyScenario);
+        return 1;
+    }
+
+    if (failedChecks > 0)
+    {
+        fprintf(stderr, "%u scenario(s) draw differently than expected\n", failedChecks);
+        return 1;
+    }
+
+    return 0;
+}
+
+// Local Functions
+// ----------------------------------------------------------------------------
+static void SetupLevel1(void)
+{
+    InitNewLevel(1);
+}
+
+static void SetupLevel30(void)
+{
+    InitNewLevel(30);
+}
+
+static void Setup10kRocks(void)
+{
+    InitNewLevel(1);
+    CreateRocks(10000);
+}
+
+static void Setup100kRocks(void)
+{
+    InitNewLevel(1);
+    CreateRocks(100000);
+}
+
+static void SetupMissileFire(void)
+{
+    InitNewLevel(1);
+    CreateRocks(2000);
+}
+
+static void SetupMissileStorm(void)
+{
+    InitNewLevel(1);
+    CreateRocks(2000);
+    game.missileLimit = 0; // no limit
+}
+
+static void SetupScreenEdges(void)
+{
+    // Rocks straddling the edges and moving along them, so they always need
+    // wrapped collision checks and clones drawn on the opposite side
+    InitNewLevel(1);
+    const unsigned int count = 2000;
+    ReserveAsteroids(game.rockCount + count);
+    RandomStream *spawnRandom = &game.random[RANDOM_STREAM_ROCK_SPAWN];
+    for (unsigned int i = 0; i < count; i++)
+    {
+        SizeOfAsteroid size = (SizeOfAsteroid)(i%3);
+        float along = (float)GetRandomInt(spawnRandom, 0, 1000)/1000.0f;
+        float across = (float)GetRandomInt(spawnRandom, -ASTEROID_RADIUS_SMALL, ASTEROID_RADIUS_SMALL);
+        Vector2 position = { 0 };
+        float angle = 0.0f;
+        switch (i%4)
+        {
+            case 0: position = (Vector2){ along*VIRTUAL_WIDTH, across }; angle = 90; break; // top
+            case 1: position = (Vector2){ along*VIRTUAL_WIDTH, VIRTUAL_HEIGHT + across }; angle = 270; break; // bottom
+            case 2: position = (Vector2){ across, along*VIRTUAL_HEIGHT }; angle = 0; break; // left
+            default: position = (Vector2){ VIRTUAL_WIDTH + across, along*VIRTUAL_HEIGHT }; angle = 180; break; // right
+        }
+        WrapPastEdge(&position);
+        CreateAsteroid(size, position, angle, ColorBrightnessVariation(BROWN));
+    }
+}
+
+static void CreateRocks(unsigned int count)
+{
+    ReserveAsteroids(game.rockCount + count);
+    for (unsigned int i = 0; i < count; i++)
+        CreateAsteroidRandom((SizeOfAsteroid)(i%3));
+}
+
+static void SetBenchInput(unsigned int tick, const BenchScenario *scenario)
+{
+    input.player.rotateLeft = ((tick/120)%3 == 0);
+    input.player.rotateRight = ((tick/120)%3 == 1);
+    input.player.thrust = ((tick/60)%4 == 0);
+    input.player.shoot = true;
+    if (scenario->rapidFire)
+        game.ship.autoFireTimer = 0; // fire on this tick
+
+    // Turning a little each tick, so the missiles don't follow each other
+    for (unsigned int i = 0; i < scenario->volley; i++)
+        CreateMissile(game.ship.position, (float)tick + 360.0f*i/scenario->volley);
+}
+
+static void KeepShipAlive(void)
+{
+    if (!game.ship.isExploded)
+        return;
+
+    // Not a respawn, the shield would stop collision and add to the drawing
+    game.ship.isExploded = false;
+    game.ship.explosionTimer = 0;
+    game.ship.respawnTimer = SHIP_RESPAWN_TIME;
+    game.lives = STARTING_LIVES;
+    game.messageTimer = 0;
+}
+
+static int CompareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static BenchStats GetBenchStats(double *samples, unsigned int count)
+{
+    BenchStats stats = { 0 };
+    for (unsigned int i = 0; i < count; i++)
+        stats.mean += samples[i];
+    stats.mean /= count;
+
+    qsort(samples, count, sizeof(double), CompareDoubles);
+    stats.p50 = samples[(count - 1)/2];
+    stats.p99 = samples[(unsigned int)((count - 1)*0.99)];
+    stats.max = samples[count - 1];
+
+    return stats;
+}
+
+static void PrintBenchStats(const char *name, BenchStats stats, bool lastField)
+{
+    printf("      \"%s\": { \"mean\": %.3f, \"p50\": %.3f, \"p99\": %.3f, \"max\": %.3f }%s\n",
+           name, stats.mean, stats.p50, stats.p99, stats.max, lastField? "" : ",");
+}
@@ -0,0 +1,354 @@
+// EXPLANATION:
+// Counts what drawing costs each frame
+// See drawstats.h for more documentation/descriptions
+
+#define DRAW_STATS_IMPLEMENTATION // the wrappers below call the real raylib functions
+#include "drawstats.h"
+
+#include <math.h> // for the ring segment count
+
+#include "rlgl.h"
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+// What raylib's active render batch would hold right now
+typedef struct DrawStatsBatch {
+    unsigned int capacity; // vertices
+    unsigned int vertexCount; // in the buffer, padding included
+    unsigned int drawCount; // draws in the batch, the last one is still being added to
+    unsigned int drawVertexCount; // vertices in the last draw
+    unsigned int textureId; // of the last draw
+    int mode; // of the last draw, RL_QUADS or RL_LINES
+} DrawStatsBatch;
+
+typedef struct DrawStatsState {
+    DrawStatsBatch batch;
+    DrawStats frame; // being counted
+    DrawStats lastFrame;
+    DrawStats screenTotals[DRAW_STATS_SCREENS];
+    unsigned int screenFrames[DRAW_STATS_SCREENS];
+    unsigned int lastTextureId; // of the last finished draw
+} DrawStatsState;
+
+// Globals
+// ----------------------------------------------------------------------------
+static DrawStatsState drawStats = { .batch = { .capacity = RL_DEFAULT_BATCH_BUFFER_ELEMENTS*4, .drawCount = 1, .mode = RL_QUADS } };
+
+// Local Functions
+// ----------------------------------------------------------------------------
+// The batch functions follow the rlgl function named in their comment (see rlgl.h)
+
+// A draw is finished, in the order they're drawn
+static void CountDrawTexture(unsigned int textureId)
+{
+    if (textureId != drawStats.lastTextureId)
+        drawStats.frame.textureChanges++;
+    drawStats.lastTextureId = textureId;
+}
+
+// rlDrawRenderBatch(), every draw in the batch is a draw call
+static void FlushBatch(void)
+{
+    DrawStatsBatch *batch = &drawStats.batch;
+    if (batch->vertexCount > 0)
+    {
+        CountDrawTexture(batch->textureId);
+        drawStats.frame.drawCalls += batch->drawCount;
+        drawStats.frame.vertices += batch->vertexCount;
+        drawStats.frame.batchFlushes++;
+    }
+
+    batch->vertexCount = 0;
+    batch->drawCount = 1;
+    batch->drawVertexCount = 0;
+    batch->textureId = rlGetTextureIdDefault();
+    batch->mode = RL_QUADS;
+}
+
+// rlCheckRenderBatchLimit(), the next batch carries on with the same draw
+static bool CheckBatchLimit(unsigned int vertexCount)
+{
+    DrawStatsBatch *batch = &drawStats.batch;
+    if (batch->vertexCount + vertexCount < batch->capacity)
+        return false;
+
+    unsigned int textureId = batch->textureId;
+    int mode = batch->mode;
+    FlushBatch();
+    batch->textureId = textureId;
+    batch->mode = mode;
+    return true;
+}
+
+// Start of rlSetTexture() and rlBegin(), the last draw is padded so the next
+// one starts on a multiple of 4 vertices, which flushes when there's no room
+static void EndDraw(void)
+{
+    DrawStatsBatch *batch = &drawStats.batch;
+    if (batch->drawVertexCount > 0)
+    {
+        unsigned int alignment = 0;
+        if (batch->mode == RL_LINES) alignment = (batch->drawVertexCount < 4)? batch->drawVertexCount : batch->drawVertexCount%4;
+        else if (batch->mode == RL_TRIANGLES) alignment = (batch->drawVertexCount < 4)? 1 : 4 - batch->drawVertexCount%4;
+
+        if (!CheckBatchLimit(alignment))
+        {
+            CountDrawTexture(batch->textureId);
+            batch->vertexCount += alignment;
+            batch->drawCount++;
+            batch->textureId = rlGetTextureIdDefault();
+            batch->mode = RL_QUADS;
+        }
+    }
+
+    if (batch->drawCount >= RL_DEFAULT_BATCH_DRAWCALLS)
+        FlushBatch();
+    batch->drawVertexCount = 0;
+}
+
+// rlSetTexture()
+static void SetBatchTexture(unsigned int textureId)
+{
+    DrawStatsBatch *batch = &drawStats.batch;
+    if (textureId == 0)
+    {
+        if (batch->vertexCount >= batch->capacity)
+            FlushBatch();
+    }
+    else if (textureId != batch->textureId)
+    {
+        EndDraw();
+        batch->textureId = textureId;
+    }
+}
+
+// rlBegin()
+static void BeginBatchMode(int mode)
+{
+    DrawStatsBatch *batch = &drawStats.batch;
+    if (mode != batch->mode)
+    {
+        EndDraw();
+        batch->mode = mode;
+        batch->textureId = rlGetTextureIdDefault();
+    }
+}
+
+// Add primitives of one type like raylib's shape and texture functions do:
+// rlSetTexture(), rlBegin(), the vertices, then rlSetTexture(0)
+// - Lines don't set a texture, pass 0
+static void CountPrimitives(int mode, unsigned int textureId, unsigned int primitiveVertices, unsigned int primitiveCount)
+{
+    DrawStatsBatch *batch = &drawStats.batch;
+    if (textureId != 0)
+        SetBatchTexture(textureId);
+    BeginBatchMode(mode);
+
+    // rlVertex3f(), a primitive is never split between batches
+    for (unsigned int i = 0; i < primitiveCount; i++)
+    {
+        if (batch->vertexCount > batch->capacity - 4)
+            CheckBatchLimit(primitiveVertices + 1);
+        batch->vertexCount += primitiveVertices;
+        batch->drawVertexCount += primitiveVertices;
+    }
+
+    if (textureId != 0)
+        SetBatchTexture(0);
+}
+
+// Circles and sectors are drawn as quads covering two segments each
+static void CountCircleSector(unsigned int segments)
+{
+    CountPrimitives(RL_QUADS, GetShapesTexture().id, 4, segments/2 + segments%2);
+}
+
+static void CountText(const char *text)
+{
+    unsigned int textureId = GetFontDefault().texture.id;
+    if (textureId == 0)
+        return; // raylib doesn't draw text without a font
+
+    // One quad per visible character (UTF-8 continuation bytes are part of the character before)
+    unsigned int glyphCount = 0;
+    for (const unsigned char *c = (const unsigned char *)text; *c != '\0'; c++)
+    {
+        if ((*c != ' ') && (*c != '\t') && (*c != '\n') && ((*c & 0xC0) != 0x80))
+            glyphCount++;
+    }
+    CountPrimitives(RL_QUADS, textureId, 4, glyphCount);
+}
+
+// Draw Stats
+// ----------------------------------------------------------------------------
+void BeginDrawStatsFrame(void)
+{
+    drawStats.frame = (DrawStats){ 0 };
+    drawStats.lastTextureId = 0;
+}
+
+void EndDrawStatsFrame(int screen)
+{
+    FlushBatch();
+    drawStats.lastFrame = drawStats.frame;
+    if ((screen >= 0) && (screen < DRAW_STATS_SCREENS))
+    {
+        DrawStats *total = &drawStats.screenTotals[screen];
+        total->drawCalls += drawStats.frame.drawCalls;
+        total->batchFlushes += drawStats.frame.batchFlushes;
+        total->vertices += drawStats.frame.vertices;
+        total->textureChanges += drawStats.frame.textureChanges;
+        drawStats.screenFrames[screen]++;
+    }
+}
+
+DrawStats GetDrawStats(void)
+{
+    return drawStats.lastFrame;
+}
+
+DrawStats GetScreenDrawStats(int screen)
+{
+    DrawStats average = { 0 };
+    if ((screen < 0) || (screen >= DRAW_STATS_SCREENS) || (drawStats.screenFrames[screen] == 0))
+        return average;
+
+    DrawStats *total = &drawStats.screenTotals[screen];
+    unsigned int frames = drawStats.screenFrames[screen];
+    average.drawCalls = total->drawCalls/frames;
+    average.batchFlushes = total->batchFlushes/frames;
+    average.vertices = total->vertices/frames;
+    average.textureChanges = total->textureChanges/frames;
+    return average;
+}
+
+void SetDrawStatsBatchSize(unsigned int elements)
+{
+    FlushBatch();
+    drawStats.batch.capacity = elements*4;
+}
+
+// Counting Wrappers
+// ----------------------------------------------------------------------------
+void CountedBeginMode2D(Camera2D camera)
+{
+    FlushBatch();
+    BeginMode2D(camera);
+}
+
+void CountedEndMode2D(void)
+{
+    FlushBatch();
+    EndMode2D();
+}
+
+void CountedBeginScissorMode(int x, int y, int width, int height)
+{
+    FlushBatch();
+    BeginScissorMode(x, y, width, height);
+}
+
+void CountedEndScissorMode(void)
+{
+    FlushBatch();
+    EndScissorMode();
+}
+
+void CountedBeginTextureMode(RenderTexture2D target)
+{
+    FlushBatch();
+    BeginTextureMode(target);
+}
+
+void CountedEndTextureMode(void)
+{
+    FlushBatch();
+    EndTextureMode();
+}
+
+void CountedEndDrawing(void)
+{
+    FlushBatch();
+    EndDrawing();
+}
+
+void CountedDrawFPS(int posX, int posY)
+{
+    CountText(TextFormat("%2i FPS", GetFPS()));
+    DrawFPS(posX, posY);
+}
+
+void CountedDrawText(const char *text, int posX, int posY, int fontSize, Color color)
+{
+    CountText(text);
+    DrawText(text, posX, posY, fontSize, color);
+}
+
+void CountedDrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint)
+{
+    if (texture.id > 0) // raylib skips textures that aren't loaded
+        CountPrimitives(RL_QUADS, texture.id, 4, 1);
+    DrawTexturePro(texture, source, dest, origin, rotation, tint);
+}
+
+void CountedDrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint)
+{
+    if (texture.id > 0)
+        CountPrimitives(RL_QUADS, texture.id, 4, 1);
+    DrawTextureEx(texture, position, rotation, scale, tint);
+}
+
+void CountedDrawCircleV(Vector2 center, float radius, Color color)
+{
+    CountCircleSector(36); // DrawCircleV() always uses 36 segments
+    DrawCircleV(center, radius, color);
+}
+
+void CountedDrawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color)
+{
+    CountPrimitives(RL_QUADS, GetShapesTexture().id, 4, 1); // a quad with a repeated corner
+    DrawTriangle(v1, v2, v3, color);
+}
+
+void CountedDrawRectangle(int posX, int posY, int width, int height, Color color)
+{
+    CountPrimitives(RL_QUADS, GetShapesTexture().id, 4, 1);
+    DrawRectangle(posX, posY, width, height, color);
+}
+
+void CountedDrawRectangleLinesEx(Rectangle rec, float lineThick, Color color)
+{
+    CountPrimitives(RL_QUADS, GetShapesTexture().id, 4, 4); // one rectangle per side
+    DrawRectangleLinesEx(rec, lineThick, color);
+}
+
+void CountedDrawRing(Vector2 center, float innerRadius, float outerRadius, float startAngle, float endAngle, int segments, Color color)
+{
+    // Same segment count as DrawRing() works out
+    float start = fminf(startAngle, endAngle);
+    float end = fmaxf(startAngle, endAngle);
+    float radius = fmaxf(fmaxf(innerRadius, outerRadius), 0.1f);
+    if (start != end)
+    {
+        int minSegments = (int)ceilf((end - start)/90);
+        if (segments < minSegments)
+        {
+            float th = acosf(2*powf(1 - 0.5f/radius, 2) - 1); // 0.5 is raylib's SMOOTH_CIRCLE_ERROR_RATE
+            segments = (int)((end - start)*ceilf(2*PI/th)/360);
+            if (segments <= 0) segments = minSegments;
+        }
+
+        if (fminf(innerRadius, outerRadius) <= 0.0f)
+            CountCircleSector((unsigned int)segments); // not a ring, drawn as a circle sector
+        else
+            CountPrimitives(RL_QUADS, GetShapesTexture().id, 4, (unsigned int)segments);
+    }
+    DrawRing(center, innerRadius, outerRadius, startAngle, endAngle, segments, color);
+}
+
+void CountedDrawLine(int startPosX, int startPosY, int endPosX, int endPosY, Color color)
+{
+    CountPrimitives(RL_LINES, 0, 2, 1); // DrawLine() doesn't set a texture, rlBegin() picks the default one
+    DrawLine(startPosX, startPosY, endPosX, endPosY, color);
+}
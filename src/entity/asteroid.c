@@ -1,105 +1,206 @@
 #include "asteroid.h"
+#include <string.h> // for memcpy when growing the pool
 #include "raymath.h" // needed for vector math
 #include "config.h"
 #include "game.h"
+#include "jobs.h"
+#include "render.h"
 
-unsigned int CreateAsteroid(SizeOfAsteroid size, Vector2 position, float angle, Color color)
+// Pick the widest SIMD instructions the compiler is targeting
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define ASTEROID_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define ASTEROID_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define ASTEROID_SIMD_NEON
+#endif
+
+// Point each array of the pool into one memory block
+static void SetAsteroidPoolMemory(AsteroidPool *rocks, void *memory, unsigned int capacity)
 {
-    game.rockCount++;
-    game.rocks = MemRealloc(game.rocks, game.rockCount*sizeof(Asteroid));
-    unsigned int rockIdx = game.rockCount - 1;
-    Asteroid *rock = &game.rocks[rockIdx];
-
-    *rock = (Asteroid){ 0 };
-    rock->isExploded = false;
-    rock->color = color;
-    rock->size = size;
-    if (size == ASTEROID_SIZE_SMALL)
-    {
-        rock->radius = ASTEROID_RADIUS_SMALL;
-        rock->soundExplode = &game.sounds.explodeSmall;
-        rock->sprite = &game.textures.asteroidA;
-    }
-    else if (size == ASTEROID_SIZE_MEDIUM)
+    unsigned char *block = memory;
+    rocks->memory = memory;
+
+    // Largest alignment first
+    rocks->positionX = (float *)block;        block += capacity*sizeof(float);
+    rocks->positionY = (float *)block;        block += capacity*sizeof(float);
+    rocks->velocityX = (float *)block;        block += capacity*sizeof(float);
+    rocks->velocityY = (float *)block;        block += capacity*sizeof(float);
+    rocks->spriteAngle = (float *)block;      block += capacity*sizeof(float);
+    rocks->spriteSpin = (float *)block;       block += capacity*sizeof(float);
+    rocks->previousX = (float *)block;        block += capacity*sizeof(float);
+    rocks->previousY = (float *)block;        block += capacity*sizeof(float);
+    rocks->previousAngle = (float *)block;    block += capacity*sizeof(float);
+    rocks->radius = (float *)block;           block += capacity*sizeof(float);
+    rocks->color = (Color *)block;            block += capacity*sizeof(Color);
+    rocks->size = (unsigned char *)block;     block += capacity*sizeof(unsigned char);
+    rocks->isExploded = (bool *)block;
+}
+
+static unsigned int GetAsteroidPoolMemorySize(unsigned int capacity)
+{
+    return capacity*(10*sizeof(float) + sizeof(Color) + sizeof(unsigned char) + sizeof(bool));
+}
+
+void ReserveAsteroids(unsigned int capacity)
+{
+    if (capacity <= world.rockCapacity)
+        return;
+
+    // Whole batches of 8 for the movement kernel
+    capacity = (capacity + 7) & ~7u;
+
+    AsteroidPool old = world.rocks;
+    AllocAsteroidPool(&world.rocks, capacity);
+    if (old.memory != NULL)
     {
-        rock->radius = ASTEROID_RADIUS_MEDIUM;
-        rock->soundExplode = &game.sounds.explodeMedium;
-        rock->sprite = &game.textures.asteroidB;
+        CopyAsteroids(&world.rocks, &old, game.rockCount);
+        MemFree(old.memory);
     }
+
+    world.rockCapacity = capacity;
+}
+
+void AllocAsteroidPool(AsteroidPool *rocks, unsigned int capacity)
+{
+    SetAsteroidPoolMemory(rocks, MemAlloc(GetAsteroidPoolMemorySize(capacity)), capacity);
+}
+
+void CopyAsteroids(AsteroidPool *dest, const AsteroidPool *source, unsigned int count)
+{
+    memcpy(dest->positionX, source->positionX, count*sizeof(float));
+    memcpy(dest->positionY, source->positionY, count*sizeof(float));
+    memcpy(dest->velocityX, source->velocityX, count*sizeof(float));
+    memcpy(dest->velocityY, source->velocityY, count*sizeof(float));
+    memcpy(dest->spriteAngle, source->spriteAngle, count*sizeof(float));
+    memcpy(dest->spriteSpin, source->spriteSpin, count*sizeof(float));
+    memcpy(dest->previousX, source->previousX, count*sizeof(float));
+    memcpy(dest->previousY, source->previousY, count*sizeof(float));
+    memcpy(dest->previousAngle, source->previousAngle, count*sizeof(float));
+    memcpy(dest->radius, source->radius, count*sizeof(float));
+    memcpy(dest->color, source->color, count*sizeof(Color));
+    memcpy(dest->size, source->size, count*sizeof(unsigned char));
+    memcpy(dest->isExploded, source->isExploded, count*sizeof(bool));
+}
+
+unsigned int CreateAsteroid(SizeOfAsteroid size, Vector2 position, float angle, Color color)
+{
+    // Live rocks are kept dense, so the next free slot is always at the end
+    // The pool is reserved per level, this only grows if a level outgrows it
+    if (game.rockCount == world.rockCapacity)
+        ReserveAsteroids((world.rockCapacity > 0)? world.rockCapacity*2 : 16);
+
+    unsigned int rockIdx = game.rockCount;
+    game.rockCount++;
+    AsteroidPool *rocks = &world.rocks;
+
+    float radius = ASTEROID_RADIUS_SMALL;
+    if (size == ASTEROID_SIZE_MEDIUM)
+        radius = ASTEROID_RADIUS_MEDIUM;
     else if (size == ASTEROID_SIZE_BIG)
-    {
-        rock->radius = ASTEROID_RADIUS_BIG;
-        rock->soundExplode = &game.sounds.explodeBig;
-        rock->sprite = &game.textures.asteroidC;
-    }
+        radius = ASTEROID_RADIUS_BIG;
+    rocks->radius[rockIdx] = radius;
+    rocks->size[rockIdx] = (unsigned char)size;
+    rocks->color[rockIdx] = color;
+    rocks->isExploded[rockIdx] = false;
+
     unsigned int newRockAdd = 1;
-    for (int i = rock->size; i >= 0; i--)
+    for (int i = size; i >= 0; i--)
         newRockAdd *= 2;
     game.rockLimit += newRockAdd;
 
     // position & angle
-    rock->position = position;
-    rock->angle = angle;
-    rock->spriteAngle = (float)GetRandomValue(0, 180);
-    rock->rotateLeft = GetRandomValue(0, 1);
+    rocks->positionX[rockIdx] = position.x;
+    rocks->positionY[rockIdx] = position.y;
+    RandomStream *lookRandom = &game.random[RANDOM_STREAM_ROCK_LOOK];
+    rocks->spriteAngle[rockIdx] = (float)GetRandomInt(lookRandom, 0, 180);
+    rocks->previousX[rockIdx] = position.x; // new rocks don't blend in from anywhere
+    rocks->previousY[rockIdx] = position.y;
+    rocks->previousAngle[rockIdx] = rocks->spriteAngle[rockIdx];
+    bool rotateLeft = GetRandomInt(lookRandom, 0, 1);
 
     // Speed proportional to size
     float radiusRange = ASTEROID_RADIUS_BIG - ASTEROID_RADIUS_SMALL;
     float scaledSpeed;
-    scaledSpeed = ASTEROID_SPEED*(ASTEROID_RADIUS_BIG - rock->radius)/radiusRange;
+    scaledSpeed = ASTEROID_SPEED*(ASTEROID_RADIUS_BIG - radius)/radiusRange;
     if (scaledSpeed < ASTEROID_SPEED/8) // minimum speed
         scaledSpeed = ASTEROID_SPEED/8;
-    rock->speed = scaledSpeed;
+
+    // Direction never changes, so work out the velocity once
+    Vector2 velocity = Vector2Rotate((Vector2){ 0, scaledSpeed }, angle*DEG2RAD);
+    rocks->velocityX[rockIdx] = velocity.x;
+    rocks->velocityY[rockIdx] = velocity.y;
+
+    float spriteRotation = fmodf((float)(scaledSpeed / 120), 180);
+    if (rotateLeft) spriteRotation = -spriteRotation;
+    rocks->spriteSpin[rockIdx] = spriteRotation;
 
     return rockIdx;
 }
 
 unsigned int CreateAsteroidRandom(SizeOfAsteroid size)
 {
-    float rockPosX = (float)GetRandomValue(0, VIRTUAL_WIDTH);
-    float rockPosY = (float)GetRandomValue(0, VIRTUAL_HEIGHT);
-    float angle = (float)GetRandomValue(0, 360);
+    RandomStream *spawnRandom = &game.random[RANDOM_STREAM_ROCK_SPAWN];
+    float rockPosX = (float)GetRandomInt(spawnRandom, 0, VIRTUAL_WIDTH);
+    float rockPosY = (float)GetRandomInt(spawnRandom, 0, VIRTUAL_HEIGHT);
+    float angle = (float)GetRandomInt(spawnRandom, 0, 360);
     Color colorVariation = ColorBrightnessVariation(BROWN);
 
     unsigned int rockIdx = CreateAsteroid(size, (Vector2){ rockPosX, rockPosY }, angle, colorVariation);
-    Asteroid *rock = &game.rocks[rockIdx];
+    AsteroidPool *rocks = &world.rocks;
 
-    float safeZoneRadius = game.ship.length*3;
-    rock->radius += safeZoneRadius;
-    if (CheckCollisionAsteroidShip(rockIdx, &game.ship))
+    float safeZoneRadius = SHIP_LENGTH*3;
+    rocks->radius[rockIdx] += safeZoneRadius;
+    SpaceShipHull hull; // the ship may have just moved for a new level
+    UpdateShipHull(&hull, &game.ship, &game.ship);
+    if (CheckCollisionAsteroidShip(rockIdx, &hull))
     {
-        rock->position.x += ((GetRandomValue(0, 1)*2) - 1)*rock->radius*2;
-        rock->position.y += ((GetRandomValue(0, 1)*2) - 1)*rock->radius*2;
+        rocks->positionX[rockIdx] += ((GetRandomInt(spawnRandom, 0, 1)*2) - 1)*rocks->radius[rockIdx]*2;
+        rocks->positionY[rockIdx] += ((GetRandomInt(spawnRandom, 0, 1)*2) - 1)*rocks->radius[rockIdx]*2;
     }
-    rock->radius -= safeZoneRadius;
+    rocks->radius[rockIdx] -= safeZoneRadius;
+
+    // Moving away from the ship can push it past an edge, and rocks don't
+    // move (or wrap) while the new level message shows
+    Vector2 wrapped = { rocks->positionX[rockIdx], rocks->positionY[rockIdx] };
+    WrapPastEdge(&wrapped);
+    rocks->positionX[rockIdx] = rocks->previousX[rockIdx] = wrapped.x;
+    rocks->positionY[rockIdx] = rocks->previousY[rockIdx] = wrapped.y;
 
     return rockIdx;
 }
 
 Color ColorBrightnessVariation(Color color)
 {
-    float brightness = -0.25f*GetRandomValue(0, 2); // 3 main shades
-    brightness += 0.01f*GetRandomValue(1, 10); // sub-shades
+    RandomStream *lookRandom = &game.random[RANDOM_STREAM_ROCK_LOOK];
+    float brightness = -0.25f*GetRandomInt(lookRandom, 0, 2); // 3 main shades
+    brightness += 0.01f*GetRandomInt(lookRandom, 1, 10); // sub-shades
     color = ColorBrightness(color, brightness);
     return color;
 }
 
 void SplitAsteroid(unsigned int rockIdx)
 {
-    Asteroid *rock = &game.rocks[rockIdx];
-    float angle = (float)GetRandomValue(0, 180);
-    Vector2 spawnPosA = { 0, rock->radius/2 };
+    AsteroidPool *rocks = &world.rocks;
+    SizeOfAsteroid size = rocks->size[rockIdx];
+    Vector2 position = { rocks->positionX[rockIdx], rocks->positionY[rockIdx] };
+    Color splitColor = rocks->color[rockIdx];
+
+    float angle = (float)GetRandomInt(&game.random[RANDOM_STREAM_ROCK_SPLIT], 0, 180);
+    Vector2 spawnPosA = { 0, rocks->radius[rockIdx]/2 };
     spawnPosA = Vector2Rotate(spawnPosA, angle*DEG2RAD);
     Vector2 spawnPosB = Vector2Negate(spawnPosA);
-    spawnPosA = Vector2Add(spawnPosA, rock->position);
-    spawnPosB = Vector2Add(spawnPosB, rock->position);
+    spawnPosA = Vector2Add(spawnPosA, position);
+    spawnPosB = Vector2Add(spawnPosB, position);
 
-    if (rock->size > ASTEROID_SIZE_SMALL)
+    if (size > ASTEROID_SIZE_SMALL)
     {
-        SizeOfAsteroid splitSize = rock->size - 1;
-        Color splitColor = rock->color;
-        CreateAsteroid(splitSize, spawnPosA, angle, splitColor);
-        CreateAsteroid(splitSize, spawnPosB, angle + 180, splitColor);
+        SizeOfAsteroid splitSize = size - 1;
+        PushRockSpawn(splitSize, spawnPosA, angle, splitColor);
+        PushRockSpawn(splitSize, spawnPosB, angle + 180, splitColor);
         unsigned int splitRocksAdd = 1;
         for (int i = (int)splitSize + 1; i >= 0; i--)
             splitRocksAdd *= 2;
@@ -107,83 +208,190 @@ void SplitAsteroid(unsigned int rockIdx)
     }
 }
 
-void UpdateAsteroid(unsigned int rockIdx)
+void DestroyAsteroid(unsigned int rockIdx)
 {
-    Asteroid *rock = &game.rocks[rockIdx];
-    if (rock->isExploded) return;
+    game.rockCount--;
+    unsigned int lastIdx = game.rockCount;
+    if (rockIdx == lastIdx)
+        return;
 
-    // Update position
-    Vector2 currentVelocity = (Vector2){ 0, rock->speed*game.frameTime };
-    currentVelocity = Vector2Rotate(currentVelocity, rock->angle*DEG2RAD);
-    rock->position = Vector2Add(rock->position, currentVelocity);
-    rock->isAtScreenEdge = IsCircleOnEdge(rock->position, rock->radius);
-    WrapPastEdge(&rock->position);
+    AsteroidPool *rocks = &world.rocks;
+    rocks->positionX[rockIdx] = rocks->positionX[lastIdx];
+    rocks->positionY[rockIdx] = rocks->positionY[lastIdx];
+    rocks->velocityX[rockIdx] = rocks->velocityX[lastIdx];
+    rocks->velocityY[rockIdx] = rocks->velocityY[lastIdx];
+    rocks->spriteAngle[rockIdx] = rocks->spriteAngle[lastIdx];
+    rocks->previousX[rockIdx] = rocks->previousX[lastIdx];
+    rocks->previousY[rockIdx] = rocks->previousY[lastIdx];
+    rocks->previousAngle[rockIdx] = rocks->previousAngle[lastIdx];
+    rocks->spriteSpin[rockIdx] = rocks->spriteSpin[lastIdx];
+    rocks->radius[rockIdx] = rocks->radius[lastIdx];
+    rocks->color[rockIdx] = rocks->color[lastIdx];
+    rocks->size[rockIdx] = rocks->size[lastIdx];
+    rocks->isExploded[rockIdx] = rocks->isExploded[lastIdx];
+}
 
-    // Check collision with missiles
-    for (unsigned int i = 0; i < MISSILE_MAX; i++)
+// Same as the SIMD kernels below, one rock at a time
+// Wraps like WrapPastEdge()
+static void UpdateAsteroidsScalar(unsigned int first, unsigned int last, float frameTime)
+{
+    AsteroidPool *rocks = &world.rocks;
+    for (unsigned int i = first; i < last; i++)
+    {
+        // Separate statements so the compiler can't fuse the multiply-add
+        float stepX = rocks->velocityX[i]*frameTime;
+        float stepY = rocks->velocityY[i]*frameTime;
+        float x = rocks->positionX[i] + stepX;
+        float y = rocks->positionY[i] + stepY;
+        if (x < 0) x += VIRTUAL_WIDTH;
+        if (x > VIRTUAL_WIDTH) x -= VIRTUAL_WIDTH;
+        if (y < 0) y += VIRTUAL_HEIGHT;
+        if (y > VIRTUAL_HEIGHT) y -= VIRTUAL_HEIGHT;
+        rocks->positionX[i] = x;
+        rocks->positionY[i] = y;
+        rocks->spriteAngle[i] += rocks->spriteSpin[i];
+    }
+}
+
+// Job: move a chunk of rocks, chunks are whole batches of 8 so results don't
+// depend on how the rocks are split up
+static void UpdateAsteroidsChunk(void *data, unsigned int first, unsigned int last, unsigned int chunkIdx)
+{
+    (void)data;
+    (void)chunkIdx;
+    AsteroidPool *rocks = &world.rocks;
+    unsigned int count = last;
+    unsigned int i = first;
+
+    // Wrapping selects between the moved and moved+offset values instead of
+    // adding a masked offset, so results match the scalar code bit for bit
+    // (as long as multiply-adds aren't fused, see -ffp-contract=off)
+#if defined(ASTEROID_SIMD_AVX2)
+    const __m256 frameTime = _mm256_set1_ps(game.frameTime);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 width = _mm256_set1_ps(VIRTUAL_WIDTH);
+    const __m256 height = _mm256_set1_ps(VIRTUAL_HEIGHT);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x = _mm256_add_ps(_mm256_loadu_ps(&rocks->positionX[i]),
+                                 _mm256_mul_ps(_mm256_loadu_ps(&rocks->velocityX[i]), frameTime));
+        __m256 y = _mm256_add_ps(_mm256_loadu_ps(&rocks->positionY[i]),
+                                 _mm256_mul_ps(_mm256_loadu_ps(&rocks->velocityY[i]), frameTime));
+        x = _mm256_blendv_ps(x, _mm256_add_ps(x, width), _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+        x = _mm256_blendv_ps(x, _mm256_sub_ps(x, width), _mm256_cmp_ps(x, width, _CMP_GT_OQ));
+        y = _mm256_blendv_ps(y, _mm256_add_ps(y, height), _mm256_cmp_ps(y, zero, _CMP_LT_OQ));
+        y = _mm256_blendv_ps(y, _mm256_sub_ps(y, height), _mm256_cmp_ps(y, height, _CMP_GT_OQ));
+        _mm256_storeu_ps(&rocks->positionX[i], x);
+        _mm256_storeu_ps(&rocks->positionY[i], y);
+        _mm256_storeu_ps(&rocks->spriteAngle[i], _mm256_add_ps(_mm256_loadu_ps(&rocks->spriteAngle[i]),
+                                                               _mm256_loadu_ps(&rocks->spriteSpin[i])));
+    }
+#elif defined(ASTEROID_SIMD_SSE2)
+    const __m128 frameTime = _mm_set1_ps(game.frameTime);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 width = _mm_set1_ps(VIRTUAL_WIDTH);
+    const __m128 height = _mm_set1_ps(VIRTUAL_HEIGHT);
+    for (; i + 8 <= count; i += 8)
     {
-        Missile *shot = &game.ship.missiles[i];
-        if (!shot->isExploded && CheckCollisionCircles(rock->position, rock->radius,
-                                                     shot->position, shot->radius))
+        for (unsigned int j = i; j < i + 8; j += 4) // two halves of 4
         {
-            rock->isExploded = true;
-            shot->isExploded = true;
+            __m128 x = _mm_add_ps(_mm_loadu_ps(&rocks->positionX[j]),
+                                  _mm_mul_ps(_mm_loadu_ps(&rocks->velocityX[j]), frameTime));
+            __m128 y = _mm_add_ps(_mm_loadu_ps(&rocks->positionY[j]),
+                                  _mm_mul_ps(_mm_loadu_ps(&rocks->velocityY[j]), frameTime));
+            __m128 mask = _mm_cmplt_ps(x, zero);
+            x = _mm_or_ps(_mm_and_ps(mask, _mm_add_ps(x, width)), _mm_andnot_ps(mask, x));
+            mask = _mm_cmpgt_ps(x, width);
+            x = _mm_or_ps(_mm_and_ps(mask, _mm_sub_ps(x, width)), _mm_andnot_ps(mask, x));
+            mask = _mm_cmplt_ps(y, zero);
+            y = _mm_or_ps(_mm_and_ps(mask, _mm_add_ps(y, height)), _mm_andnot_ps(mask, y));
+            mask = _mm_cmpgt_ps(y, height);
+            y = _mm_or_ps(_mm_and_ps(mask, _mm_sub_ps(y, height)), _mm_andnot_ps(mask, y));
+            _mm_storeu_ps(&rocks->positionX[j], x);
+            _mm_storeu_ps(&rocks->positionY[j], y);
+            _mm_storeu_ps(&rocks->spriteAngle[j], _mm_add_ps(_mm_loadu_ps(&rocks->spriteAngle[j]),
+                                                             _mm_loadu_ps(&rocks->spriteSpin[j])));
         }
-
-        if (rock->isAtScreenEdge)
+    }
+#elif defined(ASTEROID_SIMD_NEON)
+    const float32x4_t frameTime = vdupq_n_f32(game.frameTime);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t width = vdupq_n_f32(VIRTUAL_WIDTH);
+    const float32x4_t height = vdupq_n_f32(VIRTUAL_HEIGHT);
+    for (; i + 8 <= count; i += 8)
+    {
+        for (unsigned int j = i; j < i + 8; j += 4) // two halves of 4
         {
-            for (unsigned int o = 0; o < 8; o++)
-            {
-                Vector2 cloneRockPos = Vector2Add(rock->position, game.wrapOffsets[o]);
-                if (!shot->isExploded && CheckCollisionCircles(cloneRockPos, rock->radius,
-                                                             shot->position, shot->radius))
-                {
-                    rock->isExploded = true;
-                    shot->isExploded = true;
-                }
-            }
+            float32x4_t x = vaddq_f32(vld1q_f32(&rocks->positionX[j]),
+                                      vmulq_f32(vld1q_f32(&rocks->velocityX[j]), frameTime));
+            float32x4_t y = vaddq_f32(vld1q_f32(&rocks->positionY[j]),
+                                      vmulq_f32(vld1q_f32(&rocks->velocityY[j]), frameTime));
+            x = vbslq_f32(vcltq_f32(x, zero), vaddq_f32(x, width), x);
+            x = vbslq_f32(vcgtq_f32(x, width), vsubq_f32(x, width), x);
+            y = vbslq_f32(vcltq_f32(y, zero), vaddq_f32(y, height), y);
+            y = vbslq_f32(vcgtq_f32(y, height), vsubq_f32(y, height), y);
+            vst1q_f32(&rocks->positionX[j], x);
+            vst1q_f32(&rocks->positionY[j], y);
+            vst1q_f32(&rocks->spriteAngle[j], vaddq_f32(vld1q_f32(&rocks->spriteAngle[j]),
+                                                        vld1q_f32(&rocks->spriteSpin[j])));
         }
     }
+#endif
 
-    float spriteRotation = fmodf((float)(rock->speed / 120), 180);
-    if (rock->rotateLeft) spriteRotation = -spriteRotation;
-    rock->spriteAngle += spriteRotation;
+    // Leftover rocks (or every rock without SIMD)
+    UpdateAsteroidsScalar(i, count, game.frameTime);
+}
 
-    if (rock->isExploded)
-    {
-        game.eliminatedCount++;
-        SplitAsteroid(rockIdx);
-        PlaySound(*game.rocks[rockIdx].soundExplode);
-    }
+void UpdateAsteroids(void)
+{
+    RunParallelFor(game.rockCount, ASTEROID_JOB_CHUNK, UpdateAsteroidsChunk, NULL);
 }
 
 void DrawAsteroid(unsigned int rockIdx)
 {
-    Asteroid *rock = &game.rocks[rockIdx];
+    AsteroidPool *rocks = &world.rocks;
+    Vector2 position = GetTickBlendPosition((Vector2){ rocks->previousX[rockIdx], rocks->previousY[rockIdx] },
+                                            (Vector2){ rocks->positionX[rockIdx], rocks->positionY[rockIdx] });
+    float radius = rocks->radius[rockIdx];
+    float spriteAngle = GetTickBlendAngle(rocks->previousAngle[rockIdx], rocks->spriteAngle[rockIdx]);
+    Color color = rocks->color[rockIdx];
 
-    Texture *sprite = rock->sprite;
-    float spriteScale = rock->radius*2.80f/sprite->width;
+    Texture *sprite = GetAsteroidSprite(rocks->size[rockIdx]);
+    float spriteScale = radius*2.80f/sprite->width;
     Rectangle spriteSrc = { 0.0f, 0.0f, (float)sprite->width, (float)sprite->height };
     Rectangle spriteDest = {
-        rock->position.x, rock->position.y,
+        position.x, position.y,
         sprite->width*spriteScale, sprite->height*spriteScale
     };
     Vector2 spriteOrigin = {
         sprite->width/2*spriteScale,
         sprite->height/2*spriteScale };
-    DrawTexturePro(*sprite, spriteSrc, spriteDest, spriteOrigin, rock->spriteAngle, rock->color);
+    QueueSprite(RENDER_LAYER_ROCKS, *sprite, spriteSrc, spriteDest, spriteOrigin, spriteAngle, color);
 
-    // Clones at opposite side of screen
-    if (rock->isAtScreenEdge)
+    // Clones past screen edges that show on screen, the sprite is bigger than
+    // the rock and can be at any angle
+    float spriteReach = sqrtf(spriteDest.width*spriteDest.width + spriteDest.height*spriteDest.height)/2;
+    Vector2 cloneOffsets[WRAP_CLONES_MAX];
+    unsigned int cloneCount = GetWrapCloneOffsets(GetCircleBounds(position, spriteReach), cloneOffsets);
+    for (unsigned int i = 0; i < cloneCount; i++)
     {
-        for (unsigned int i = 0; i < 8; i++)
-        {
-            Vector2 spriteClonePos = Vector2Add(rock->position, game.wrapOffsets[i]);
-            Rectangle spriteCloneDest = {
-                spriteClonePos.x, spriteClonePos.y,
-                sprite->width*spriteScale, sprite->height*spriteScale
-            };
-            DrawTexturePro(*sprite, spriteSrc, spriteCloneDest, spriteOrigin, rock->spriteAngle, rock->color);
-        }
+        Rectangle spriteCloneDest = spriteDest;
+        spriteCloneDest.x += cloneOffsets[i].x;
+        spriteCloneDest.y += cloneOffsets[i].y;
+        QueueSprite(RENDER_LAYER_ROCKS, *sprite, spriteSrc, spriteCloneDest, spriteOrigin, spriteAngle, color);
     }
 }
+
+Texture *GetAsteroidSprite(SizeOfAsteroid size)
+{
+    if (size == ASTEROID_SIZE_SMALL) return &assets.textures.asteroidA;
+    if (size == ASTEROID_SIZE_MEDIUM) return &assets.textures.asteroidB;
+    return &assets.textures.asteroidC;
+}
+
+Sound *GetAsteroidSound(SizeOfAsteroid size)
+{
+    if (size == ASTEROID_SIZE_SMALL) return &assets.sounds.explodeSmall;
+    if (size == ASTEROID_SIZE_MEDIUM) return &assets.sounds.explodeMedium;
+    return &assets.sounds.explodeBig;
+}
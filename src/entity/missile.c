@@ -1,55 +1,232 @@
 #include "missile.h"
+#include <string.h> // for memcpy when growing the pool
 #include "raymath.h"
 #include "game.h"
+#include "render.h"
 
-void UpdateMissile(Missile *shot)
+// Point each array of the pool into one memory block
+static void SetMissilePoolMemory(MissilePool *shots, void *memory, unsigned int capacity)
 {
-    if (shot->isExploded)
-    {
-        shot->explosionTimer -= game.frameTime;
+    unsigned char *block = memory;
+    shots->memory = memory;
+
+    // Largest alignment first
+    shots->positionX = (float *)block;      block += capacity*sizeof(float);
+    shots->positionY = (float *)block;      block += capacity*sizeof(float);
+    shots->directionX = (float *)block;     block += capacity*sizeof(float);
+    shots->directionY = (float *)block;     block += capacity*sizeof(float);
+    shots->despawnTimer = (float *)block;   block += capacity*sizeof(float);
+    shots->explosionTimer = (float *)block; block += capacity*sizeof(float);
+    shots->previousX = (float *)block;      block += capacity*sizeof(float);
+    shots->previousY = (float *)block;      block += capacity*sizeof(float);
+    shots->isExploded = (bool *)block;
+}
+
+static unsigned int GetMissilePoolMemorySize(unsigned int capacity)
+{
+    return capacity*(8*sizeof(float) + sizeof(bool));
+}
+
+// Move a missile to a lower index, when removing the ones before it
+static void MoveMissile(MissilePool *shots, unsigned int to, unsigned int from)
+{
+    shots->positionX[to] = shots->positionX[from];
+    shots->positionY[to] = shots->positionY[from];
+    shots->directionX[to] = shots->directionX[from];
+    shots->directionY[to] = shots->directionY[from];
+    shots->despawnTimer[to] = shots->despawnTimer[from];
+    shots->explosionTimer[to] = shots->explosionTimer[from];
+    shots->previousX[to] = shots->previousX[from];
+    shots->previousY[to] = shots->previousY[from];
+    shots->isExploded[to] = shots->isExploded[from];
+}
+
+// Stops it hitting anything, it's removed once its explosion is over
+static void ExplodeMissile(unsigned int missileIdx, float explosionTime)
+{
+    world.missiles.isExploded[missileIdx] = true;
+    world.missiles.explosionTimer[missileIdx] = explosionTime;
+    game.missileLiveCount--;
+}
+
+void ReserveMissiles(unsigned int capacity)
+{
+    if (capacity <= world.missileCapacity)
         return;
-    }
 
-    // Update position
-    Vector2 currentVelocity = (Vector2){ 0, shot->speed*game.frameTime };
-    currentVelocity = Vector2Rotate(currentVelocity, shot->angle*DEG2RAD);
-    currentVelocity = Vector2Add(currentVelocity, Vector2Scale(game.ship.velocity, game.frameTime));
-    shot->position = Vector2Add(shot->position, currentVelocity);
-    shot->isAtScreenEdge = IsCircleOnEdge(shot->position, shot->radius);
-    WrapPastEdge(&shot->position);
-
-    // Update despawn timer
-    shot->despawnTimer -= game.frameTime;
-    if (shot->despawnTimer <= 0)
+    MissilePool old = world.missiles;
+    AllocMissilePool(&world.missiles, capacity);
+    if (old.memory != NULL)
     {
-        shot->isExploded = true;
-        shot->explosionTimer = 0.0f;
+        CopyMissiles(&world.missiles, &old, game.missileCount);
+        MemFree(old.memory);
     }
+
+    world.missileCapacity = capacity;
 }
 
-void DrawMissile(Missile *shot)
+void AllocMissilePool(MissilePool *shots, unsigned int capacity)
 {
-    if ((shot->explosionTimer > EPSILON) && shot->isExploded)
-        DrawCircleV(shot->position, shot->radius*5, Fade(MAROON, 0.5f));
-    if (shot->isExploded) return;
+    SetMissilePoolMemory(shots, MemAlloc(GetMissilePoolMemorySize(capacity)), capacity);
+}
 
-    Color missileColor = RAYWHITE;
+void CopyMissiles(MissilePool *dest, const MissilePool *source, unsigned int count)
+{
+    memcpy(dest->positionX, source->positionX, count*sizeof(float));
+    memcpy(dest->positionY, source->positionY, count*sizeof(float));
+    memcpy(dest->directionX, source->directionX, count*sizeof(float));
+    memcpy(dest->directionY, source->directionY, count*sizeof(float));
+    memcpy(dest->despawnTimer, source->despawnTimer, count*sizeof(float));
+    memcpy(dest->explosionTimer, source->explosionTimer, count*sizeof(float));
+    memcpy(dest->previousX, source->previousX, count*sizeof(float));
+    memcpy(dest->previousY, source->previousY, count*sizeof(float));
+    memcpy(dest->isExploded, source->isExploded, count*sizeof(bool));
+}
+
+unsigned int CreateMissile(Vector2 position, float angle)
+{
+    MissilePool *shots = &world.missiles;
 
-    if (shot->overheated)
+    // At the limit the oldest live missile disappears, it's the first one
+    // since missiles stay in the order they were fired
+    if ((game.missileLimit > 0) && (game.missileLiveCount >= game.missileLimit))
     {
-        missileColor = ColorTint(missileColor, RED);
-        missileColor = ColorBrightness(missileColor, 0.7f);
+        for (unsigned int i = 0; i < game.missileCount; i++)
+        {
+            if (!shots->isExploded[i])
+            {
+                ExplodeMissile(i, 0.0f);
+                break;
+            }
+        }
     }
 
-    DrawCircleV((Vector2){ shot->position.x, shot->position.y }, shot->radius, missileColor);
+    if (game.missileCount == world.missileCapacity)
+        ReserveMissiles((world.missileCapacity > 0)? world.missileCapacity*2 : 16);
+
+    unsigned int missileIdx = game.missileCount;
+    game.missileCount++;
+    game.missileLiveCount++;
+
+    shots->positionX[missileIdx] = shots->previousX[missileIdx] = position.x;
+    shots->positionY[missileIdx] = shots->previousY[missileIdx] = position.y;
+    shots->directionX[missileIdx] = -sinf(angle*DEG2RAD); // (0, 1) rotated by angle
+    shots->directionY[missileIdx] = cosf(angle*DEG2RAD);
+    shots->despawnTimer[missileIdx] = MISSILE_DESPAWN_TIME;
+    shots->explosionTimer[missileIdx] = EXPLOSION_TIME;
+    shots->isExploded[missileIdx] = false;
+
+    return missileIdx;
+}
+
+void UpdateMissiles(void)
+{
+    MissilePool *shots = &world.missiles;
+    unsigned int count = game.missileCount;
+
+    // Move, missiles keep going with the ship's velocity
+    float step = MISSILE_SPEED*game.frameTime;
+    Vector2 shipStep = Vector2Scale(game.ship.velocity, game.frameTime);
+    for (unsigned int m = 0; m < count; m++)
+    {
+        if (shots->isExploded[m])
+        {
+            shots->explosionTimer[m] -= game.frameTime;
+            continue;
+        }
+
+        Vector2 position = {
+            shots->positionX[m] + (step*shots->directionX[m] + shipStep.x),
+            shots->positionY[m] + (step*shots->directionY[m] + shipStep.y),
+        };
+        WrapPastEdge(&position);
+        shots->positionX[m] = position.x;
+        shots->positionY[m] = position.y;
+    }
 
-    // Clones at opposite side of screen
-    if (shot->isAtScreenEdge)
+    // Hit rocks along the way from the previous tick, only checking the ones in
+    // nearby grid cells, far enough to cover how far missiles and rocks moved
+    CollisionGrid *grid = &world.rockGrid;
+    float reach = ASTEROID_RADIUS_BIG + MISSILE_RADIUS + step + Vector2Length(shipStep) + ASTEROID_SPEED*game.frameTime;
+    for (unsigned int m = 0; m < count; m++)
     {
-        for (unsigned int i = 0; i < 8; i++)
+        if (shots->isExploded[m]) continue;
+
+        Vector2 start = { shots->previousX[m], shots->previousY[m] };
+        Vector2 end = { shots->positionX[m], shots->positionY[m] };
+        unsigned int cells[COLLISION_GRID_CELLS];
+        unsigned int cellCount = GetCollisionGridCells(end, reach, cells);
+
+        // The first rock it reaches is the one it hits
+        unsigned int hitRock = 0;
+        float hitTime = 2.0f; // past the end of the tick, nothing hit yet
+        for (unsigned int c = 0; c < cellCount; c++)
         {
-            Vector2 cloneAsteroid = Vector2Add(shot->position, game.wrapOffsets[i]);
-            DrawCircleV((Vector2){ cloneAsteroid.x, cloneAsteroid.y }, shot->radius, missileColor);
+            for (unsigned int i = grid->cellStart[cells[c]]; i < grid->cellStart[cells[c] + 1]; i++)
+            {
+                unsigned int rockIdx = grid->cellRocks[i];
+                float rockHitTime = 0.0f;
+                if (!world.rocks.isExploded[rockIdx] && CheckCollisionAsteroidMissile(rockIdx, start, end, &rockHitTime) &&
+                    (rockHitTime < hitTime))
+                {
+                    hitRock = rockIdx;
+                    hitTime = rockHitTime;
+                }
+            }
+        }
+
+        if (hitTime <= 1.0f)
+        {
+            // Explode where it hit, not past the rock
+            Vector2 hitPosition = Vector2Add(start, Vector2Scale(GetWrappedDelta(start, end), hitTime));
+            WrapPastEdge(&hitPosition);
+            shots->positionX[m] = hitPosition.x;
+            shots->positionY[m] = hitPosition.y;
+
+            PushRockDestroyed(hitRock); // split and removed at the end of the tick
+            PushPlaySfx(GetAsteroidSound(world.rocks.size[hitRock]));
+            ExplodeMissile(m, shots->explosionTimer[m]);
+            continue;
         }
+
+        shots->despawnTimer[m] -= game.frameTime;
+        if (shots->despawnTimer[m] <= 0)
+            ExplodeMissile(m, 0.0f);
+    }
+
+    // Remove missiles with nothing left to show, the rest keep their order
+    unsigned int kept = 0;
+    for (unsigned int m = 0; m < count; m++)
+    {
+        if (shots->isExploded[m] && (shots->explosionTimer[m] <= EPSILON))
+            continue;
+        if (kept != m)
+            MoveMissile(shots, kept, m);
+        kept++;
+    }
+    game.missileCount = kept;
+}
+
+void DrawMissile(unsigned int missileIdx)
+{
+    MissilePool *shots = &world.missiles;
+    Vector2 previous = { shots->previousX[missileIdx], shots->previousY[missileIdx] };
+    Vector2 current = { shots->positionX[missileIdx], shots->positionY[missileIdx] };
+    Vector2 position = GetTickBlendPosition(previous, current);
+
+    if (shots->isExploded[missileIdx])
+    {
+        if (shots->explosionTimer[missileIdx] > EPSILON)
+            QueueCircle(RENDER_LAYER_EFFECTS, position, MISSILE_RADIUS*5, Fade(MAROON, 0.5f));
+        return;
     }
+
+    Color missileColor = RAYWHITE;
+    QueueCircle(RENDER_LAYER_MISSILES, position, MISSILE_RADIUS, missileColor);
+
+    // Clones past screen edges that show on screen
+    Vector2 cloneOffsets[WRAP_CLONES_MAX];
+    unsigned int cloneCount = GetWrapCloneOffsets(GetCircleBounds(position, MISSILE_RADIUS), cloneOffsets);
+    for (unsigned int i = 0; i < cloneCount; i++)
+        QueueCircle(RENDER_LAYER_MISSILES, Vector2Add(position, cloneOffsets[i]), MISSILE_RADIUS, missileColor);
 }
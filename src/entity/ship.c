@@ -4,6 +4,7 @@
 #include "input.h"
 #include "ui.h"
 #include "game.h"
+#include "render.h"
 
 void UpdateShip(SpaceShip *ship)
 {
@@ -23,6 +24,7 @@ void UpdateShip(SpaceShip *ship)
         // do not update, ship has exploded
         return;
     }
+    SpaceShip start = *ship; // collision sweeps from here
     if (ship->safeRespawnTimer > 0)
         ship->safeRespawnTimer -= game.frameTime;
 
@@ -113,43 +115,48 @@ void UpdateShip(SpaceShip *ship)
     // Update position
     Vector2 scaledVelocity = Vector2Scale(ship->velocity, game.frameTime);
     ship->position = Vector2Add(ship->position, scaledVelocity);
-    UpdateShipTriangles(ship);
 
     // Screen edge wrap
-    ship->isAtScreenEdge = IsShipOnEdge(ship);
     WrapPastEdge(&ship->position);
+    UpdateShipHull(&game.shipHull, &start, ship);
 
     // Collision
     // ----------------------------------------------------------------------------
 
-    // Check collision with asteroids
+    // Check collision with asteroids in nearby grid cells, far enough to
+    // cover how far the ship and rocks moved this tick
     if (ship->safeRespawnTimer > 0) return;
-    for (unsigned int i = 0; i < game.rockCount; i++)
+    CollisionGrid *grid = &world.rockGrid;
+    unsigned int cells[COLLISION_GRID_CELLS];
+    float sweepReach = Vector2Length(scaledVelocity) + ASTEROID_SPEED*game.frameTime;
+    unsigned int cellCount = GetCollisionGridCells(ship->position, ASTEROID_RADIUS_BIG + game.shipHull.radius + sweepReach, cells);
+    for (unsigned int c = 0; c < cellCount; c++)
     {
-        Asteroid *rock = &game.rocks[i];
-        if (!rock->isExploded && CheckCollisionAsteroidShip(i, &game.ship))
+        for (unsigned int i = grid->cellStart[cells[c]]; i < grid->cellStart[cells[c] + 1]; i++)
         {
-            ship->isExploded = true;
-            ship->explosionTimer = EXPLOSION_TIME;
-            rock->isExploded = true;
-            SplitAsteroid(i);
-            game.eliminatedCount++;
-            PlaySound(game.ship.soundExplode);
+            unsigned int rockIdx = grid->cellRocks[i];
+            if (!world.rocks.isExploded[rockIdx] && CheckCollisionAsteroidShip(rockIdx, &game.shipHull))
+            {
+                PushRockDestroyed(rockIdx); // split and removed at the end of the tick
+                PushShipHit();
+                PushPlaySfx(&assets.sounds.shipExplode);
+            }
         }
     }
-    if (game.ship.isExploded)
-    {
-        game.lives--;
-        if (game.lives > 0) game.messageTimer = 3.0f;
-        ui.textFade = 1.0f; // for respawn message
-    }
 }
 
-void DrawShip(SpaceShip *ship)
+void DrawShip(const SpaceShip *ship, SpaceShipDrawState *draw)
 {
+    // Draw a copy of the ship between the previous and current tick
+    SpaceShip blended = *ship;
+    blended.position = GetTickBlendPosition(draw->previousPosition, ship->position);
+    blended.angle = GetTickBlendAngle(draw->previousAngle, ship->angle);
+    UpdateShipJetTriangle(draw, blended.position, blended.angle);
+    ship = &blended;
+
     // Draw explosion
     if ((ship->explosionTimer > EPSILON) && ship->isExploded)
-        DrawCircleV(ship->position, ship->length, Fade(RED, 0.5f));
+        QueueCircle(RENDER_LAYER_EFFECTS, ship->position, SHIP_LENGTH, Fade(RED, 0.5f));
     if (ship->isExploded) return;
 
     Color shipColor = GRAY;
@@ -157,12 +164,12 @@ void DrawShip(SpaceShip *ship)
 
     // Draw jet triangle
     if (ship->isThrusting)
-        DrawTriangle(ship->jetPoints[0], ship->jetPoints[1], ship->jetPoints[2], jetColor);
+        QueueTriangle(RENDER_LAYER_SHIP_JET, draw->jetPoints[0], draw->jetPoints[1], draw->jetPoints[2], jetColor);
 
     // Draw ship sprite
-    Texture sprite = game.textures.ship;
-    float spriteScaleX = (ship->width*1.5f)/sprite.width;
-    float spriteScaleY = (ship->length*1.5f)/sprite.height;
+    Texture sprite = assets.textures.ship;
+    float spriteScaleX = (SHIP_WIDTH*1.5f)/sprite.width;
+    float spriteScaleY = (SHIP_LENGTH*1.5f)/sprite.height;
     Rectangle spriteSrc = { 0.0f, 0.0f, (float)sprite.width, (float)sprite.height };
     Rectangle spriteDest = {
         ship->position.x, ship->position.y,
@@ -171,45 +178,72 @@ void DrawShip(SpaceShip *ship)
     Vector2 spriteOrigin = {
         sprite.width/2*spriteScaleX,
         sprite.height/2*spriteScaleY };
-    DrawTexturePro(sprite, spriteSrc, spriteDest, spriteOrigin, ship->angle, shipColor);
+    QueueSprite(RENDER_LAYER_SHIP, sprite, spriteSrc, spriteDest, spriteOrigin, ship->angle, shipColor);
 
     // Draw respawn shield
-    if (game.ship.safeRespawnTimer > 0)
-        DrawCircleV(ship->position, ship->length, Fade(SKYBLUE, 0.15f));
+    if (ship->safeRespawnTimer > 0)
+        QueueCircle(RENDER_LAYER_EFFECTS, ship->position, SHIP_LENGTH, Fade(SKYBLUE, 0.15f));
+
+    // Clones past screen edges that show on screen, the sprite can be at any
+    // angle and the jet sticks out behind it
+    float reach = sqrtf(spriteDest.width*spriteDest.width + spriteDest.height*spriteDest.height)/2;
+    if (ship->isThrusting)
+    {
+        for (unsigned int i = 0; i < 3; i++)
+            reach = fmaxf(reach, Vector2Distance(ship->position, draw->jetPoints[i]));
+    }
 
-    // Clones at opposite side of screen
-    if (ship->isAtScreenEdge)
+    Vector2 cloneOffsets[WRAP_CLONES_MAX];
+    unsigned int cloneCount = GetWrapCloneOffsets(GetCircleBounds(ship->position, reach), cloneOffsets);
+    for (unsigned int i = 0; i < cloneCount; i++)
     {
-        for (unsigned int i = 0; i < 8; i++)
+        Rectangle spriteCloneDest = spriteDest;
+        spriteCloneDest.x += cloneOffsets[i].x;
+        spriteCloneDest.y += cloneOffsets[i].y;
+        QueueSprite(RENDER_LAYER_SHIP, sprite, spriteSrc, spriteCloneDest, spriteOrigin, ship->angle, shipColor);
+        if (ship->isThrusting)
         {
-            Vector2 spriteClonePos = Vector2Add(ship->position, game.wrapOffsets[i]);
-            Rectangle spriteCloneDest = {
-                spriteClonePos.x, spriteClonePos.y,
-                sprite.width*spriteScaleX,
-                sprite.height*spriteScaleY
-            };
-            Vector2 cloneJet[3];
-            cloneJet[0] = Vector2Add(ship->jetPoints[0], game.wrapOffsets[i]);
-            cloneJet[1] = Vector2Add(ship->jetPoints[1], game.wrapOffsets[i]);
-            cloneJet[2] = Vector2Add(ship->jetPoints[2], game.wrapOffsets[i]);
-
-            // DrawTriangle(cloneShip[0], cloneShip[1], cloneShip[2], shipColor);
-            DrawTexturePro(sprite, spriteSrc, spriteCloneDest, spriteOrigin, ship->angle, shipColor);
-            if (ship->isThrusting)
-                DrawTriangle(cloneJet[0], cloneJet[1], cloneJet[2], jetColor);
+            QueueTriangle(RENDER_LAYER_SHIP_JET, Vector2Add(draw->jetPoints[0], cloneOffsets[i]),
+                          Vector2Add(draw->jetPoints[1], cloneOffsets[i]),
+                          Vector2Add(draw->jetPoints[2], cloneOffsets[i]), jetColor);
         }
     }
 }
 
-void UpdateShipTriangles(SpaceShip *ship)
+void UpdateShipHull(SpaceShipHull *hull, const SpaceShip *previous, const SpaceShip *ship)
+{
+    // Rotate the hull once, collision checks against every nearby rock use it
+    hull->center = ship->position;
+    hull->radius = 0.0f;
+    Vector2 min = ship->position;
+    Vector2 max = ship->position;
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        hull->points[i] = Vector2Rotate(game.shipTriangle[i], ship->angle*DEG2RAD);
+        hull->points[i] = Vector2Add(hull->points[i], ship->position);
+        hull->radius = fmaxf(hull->radius, Vector2Length(game.shipTriangle[i]));
+        min = Vector2Min(min, hull->points[i]);
+        max = Vector2Max(max, hull->points[i]);
+
+        // Previous points go next to the current ones when the ship wrapped,
+        // so the bounds don't stretch across the screen
+        Vector2 previousPoint = Vector2Rotate(game.shipTriangle[i], previous->angle*DEG2RAD);
+        previousPoint = Vector2Add(previousPoint, previous->position);
+        hull->previousPoints[i] = Vector2Add(hull->points[i], GetWrappedDelta(hull->points[i], previousPoint));
+        min = Vector2Min(min, hull->previousPoints[i]);
+        max = Vector2Max(max, hull->previousPoints[i]);
+    }
+    hull->previousCenter = Vector2Add(hull->center, GetWrappedDelta(hull->center, previous->position));
+    hull->bounds = (Rectangle){ min.x, min.y, max.x - min.x, max.y - min.y };
+}
+
+void UpdateShipJetTriangle(SpaceShipDrawState *draw, Vector2 position, float angle)
 {
-    // Calculate new triangle points for drawing, collision, & screen wrap
+    // Calculate new triangle points for drawing & screen wrap
     for (unsigned int i = 0; i < 3; i++)
     {
-        ship->shipPoints[i] = Vector2Rotate(game.shipTriangle[i], ship->angle*DEG2RAD);
-        ship->shipPoints[i] = Vector2Add(ship->shipPoints[i], ship->position);
-        ship->jetPoints[i] = Vector2Rotate(game.jetTriangle[i], (ship->angle+180)*DEG2RAD);
-        ship->jetPoints[i] = Vector2Add(ship->jetPoints[i], ship->position);
+        draw->jetPoints[i] = Vector2Rotate(game.jetTriangle[i], (angle+180)*DEG2RAD);
+        draw->jetPoints[i] = Vector2Add(draw->jetPoints[i], position);
     }
 }
 
@@ -219,6 +253,17 @@ void RotateShipToMouse(SpaceShip *ship)
     ship->angle = (float)atan2(mouseDirection.y, mouseDirection.x)*RAD2DEG + 90;
 }
 
+void ExplodeShip(SpaceShip *ship)
+{
+    if (ship->isExploded) return; // hit more than one rock in the same tick
+
+    ship->isExploded = true;
+    ship->explosionTimer = EXPLOSION_TIME;
+    game.lives--;
+    if (game.lives > 0) game.messageTimer = 3.0f;
+    ui.textFade = 1.0f; // for respawn message
+}
+
 void RespawnShip(SpaceShip *ship)
 {
     ship->isExploded = false;
@@ -229,24 +274,18 @@ void RespawnShip(SpaceShip *ship)
     ship->respawnTimer = SHIP_RESPAWN_TIME;
     ship->safeRespawnTimer = SHIP_SAFE_TIME;
 
-    UpdateShipTriangles(ship);
+    // Don't blend in from where it exploded
+    game.shipDraw.previousPosition = ship->position;
+    game.shipDraw.previousAngle = ship->angle;
 }
 
 void ShootMissile(SpaceShip *ship)
 {
-    if (ship->shotCount == MISSILE_MAX) ship->shotCount = 0;
-
-    Missile *shot = &ship->missiles[ship->shotCount];
-
-    shot->isExploded = false;
-    shot->explosionTimer = EXPLOSION_TIME;
-    shot->angle = ship->angle + 180;
-    Vector2 spawnPos = { 0, ship->length*0.6f + shot->radius };
-    spawnPos = Vector2Rotate(spawnPos, shot->angle*DEG2RAD);
+    float angle = ship->angle + 180;
+    Vector2 spawnPos = { 0, SHIP_LENGTH*0.6f + MISSILE_RADIUS };
+    spawnPos = Vector2Rotate(spawnPos, angle*DEG2RAD);
     spawnPos = Vector2Add(spawnPos, ship->position);
-    shot->position = spawnPos;
-    shot->despawnTimer = MISSILE_DESPAWN_TIME;
+    CreateMissile(spawnPos, angle);
 
-    ship->shotCount++;
-    PlaySound(ship->soundShoot);
+    PushPlaySfx(&assets.sounds.shipShoot);
 }
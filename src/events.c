@@ -0,0 +1,88 @@
+// EXPLANATION:
+// Queue of things that happen to entities during a tick
+// See events.h for more documentation/descriptions
+
+#include "events.h"
+
+#include "assets.h"
+#include "game.h"
+
+void PushGameEvent(GameEvent event)
+{
+    GameEventQueue *queue = &world.events;
+    if (queue->count == queue->capacity)
+    {
+        queue->capacity = (queue->capacity > 0)? queue->capacity*2 : 64;
+        queue->events = MemRealloc(queue->events, queue->capacity*sizeof(GameEvent));
+    }
+    queue->events[queue->count++] = event;
+}
+
+void PushRockDestroyed(unsigned int rockIdx)
+{
+    world.rocks.isExploded[rockIdx] = true;
+    PushGameEvent((GameEvent){ .type = GAME_EVENT_ROCK_DESTROYED, .rockIdx = rockIdx });
+}
+
+void PushRockSpawn(SizeOfAsteroid size, Vector2 position, float angle, Color color)
+{
+    PushGameEvent((GameEvent){ .type = GAME_EVENT_ROCK_SPAWN, .size = size,
+                               .position = position, .angle = angle, .color = color });
+}
+
+void PushShipHit(void)
+{
+    PushGameEvent((GameEvent){ .type = GAME_EVENT_SHIP_HIT });
+}
+
+void PushPlaySfx(Sound *sound)
+{
+    PushGameEvent((GameEvent){ .type = GAME_EVENT_PLAY_SFX, .sound = sound });
+}
+
+void ApplyGameEvents(void)
+{
+    GameEventQueue *queue = &world.events;
+    bool anyRockDestroyed = false;
+
+    // Splitting a rock pushes spawn events, which are carried out in this same pass
+    for (unsigned int i = 0; i < queue->count; i++)
+    {
+        GameEvent event = queue->events[i]; // copy, pushing can move the queue
+        switch (event.type)
+        {
+            case GAME_EVENT_ROCK_DESTROYED:
+                game.eliminatedCount++;
+                SplitAsteroid(event.rockIdx);
+                anyRockDestroyed = true;
+                break;
+            case GAME_EVENT_ROCK_SPAWN:
+                CreateAsteroid(event.size, event.position, event.angle, event.color);
+                break;
+            case GAME_EVENT_SHIP_HIT:
+                ExplodeShip(&game.ship);
+                break;
+            case GAME_EVENT_PLAY_SFX:
+                PlayGameSound(*event.sound);
+                break;
+        }
+    }
+    queue->count = 0;
+
+    // Remove destroyed rocks last, going backwards so the rock moved into
+    // each gap has already been checked (new rocks are never destroyed)
+    if (anyRockDestroyed)
+    {
+        for (unsigned int i = game.rockCount; i > 0; i--)
+        {
+            if (world.rocks.isExploded[i - 1])
+                DestroyAsteroid(i - 1);
+        }
+    }
+}
+
+void FreeGameEvents(void)
+{
+    MemFree(world.events.events);
+    world.events = (GameEventQueue){ 0 };
+}
@@ -5,13 +5,19 @@
 #include "game.h"
 
 #include <limits.h> // for SHRT_MAX for beep sound math
+#include <string.h> // for memcpy of rock positions each tick
 #include "raymath.h" // needed for vector math
 
 #include "config.h"
+#include "assets.h"
 #include "input.h"
 #include "ui.h"
+#include "profiler.h"
+#include "jobs.h"
+#include "render.h"
 
 #define ARRAY_SIZE(arr) (sizeof(arr)/sizeof((arr)[0]))
+#define COLLISION_MARGIN 0.01f // early outs are this much looser, so rounding never skips a hit
 
 // Initialization
 // ----------------------------------------------------------------------------
@@ -29,8 +35,6 @@ void InitGameState(ScreenState screen)
                 VIRTUAL_WIDTH/2,
                 VIRTUAL_HEIGHT/2,
             },
-            .width = SHIP_WIDTH,
-            .length = SHIP_LENGTH,
             .angle = 90.0f, // pointing right
             .respawnTimer = SHIP_RESPAWN_TIME,
         },
@@ -47,67 +51,45 @@ void InitGameState(ScreenState screen)
             (Vector2){  SHIP_WIDTH/6, -SHIP_WIDTH/3 },
         },
 
-        .wrapOffsets = {
-            {  VIRTUAL_WIDTH, 0 },  // right
-            { -VIRTUAL_WIDTH, 0 },  // left
-            { 0, -VIRTUAL_HEIGHT }, // up
-            { 0,  VIRTUAL_HEIGHT }, // down
-            {  VIRTUAL_WIDTH, -VIRTUAL_HEIGHT }, // top-right
-            { -VIRTUAL_WIDTH, -VIRTUAL_HEIGHT }, // top-left
-            {  VIRTUAL_WIDTH,  VIRTUAL_HEIGHT }, // bottom-right
-            { -VIRTUAL_WIDTH,  VIRTUAL_HEIGHT }  // bottom-left
-        },
-
         .currentScreen = screen,
         .currentLevel = 1,
         .lives = STARTING_LIVES,
+        .missileLimit = MISSILE_LIMIT_DEFAULT,
         .debugMode = false,
     };
 
-    // Generate random stars
-    for (unsigned int i = 0; i < STAR_AMOUNT; i++)
-    {
-        defaults.stars[i].x = (float)GetRandomValue(0, VIRTUAL_WIDTH);
-        defaults.stars[i].y = (float)GetRandomValue(0, VIRTUAL_HEIGHT);
-    }
-
-    // Missiles / Shots
-    for (unsigned int i = 0; i < MISSILE_MAX; i++)
-    {
-        Missile *shot = &defaults.ship.missiles[i];
-        shot->speed = MISSILE_SPEED;
-        shot->radius = MISSILE_RADIUS;
-        shot->isExploded = true; // aka non-existant
-    }
-
-    // Load sound and texture assets
+    // Queue sound and texture assets to load in the background (see assets.h),
+    // the rock pool and other arrays in the world are kept for the next game
     if (!allocated)
     {
-        defaults.sounds.menu =  LoadSound("assets/menu_beep.wav");
-        defaults.sounds.explodeSmall = LoadSound("assets/explode_small.wav");
-        defaults.sounds.explodeMedium = LoadSound("assets/explode_medium.wav");
-        defaults.sounds.explodeBig = LoadSound("assets/explode_big.wav");
-        defaults.ship.soundShoot = LoadSound("assets/shoot.wav");
-        defaults.ship.soundExplode = LoadSound("assets/explode_medium.wav");
-
-        defaults.textures.ship = LoadTexture("assets/ship.png");
-        defaults.textures.asteroidA = LoadTexture("assets/asteroid_a.png");
-        defaults.textures.asteroidB = LoadTexture("assets/asteroid_b.png");
-        defaults.textures.asteroidC = LoadTexture("assets/asteroid_c.png");
+        QueueGameSound(&assets.sounds.menu, "assets/menu_beep.wav");
+        QueueGameSound(&assets.sounds.explodeSmall, "assets/explode_small.wav");
+        QueueGameSound(&assets.sounds.explodeMedium, "assets/explode_medium.wav");
+        QueueGameSound(&assets.sounds.explodeBig, "assets/explode_big.wav");
+        QueueGameSound(&assets.sounds.shipShoot, "assets/shoot.wav");
+        QueueGameSound(&assets.sounds.shipExplode, "assets/explode_medium.wav");
+
+        QueueGameTexture(&assets.textures.ship, "assets/ship.png");
+        QueueGameTexture(&assets.textures.asteroidA, "assets/asteroid_a.png");
+        QueueGameTexture(&assets.textures.asteroidB, "assets/asteroid_b.png");
+        QueueGameTexture(&assets.textures.asteroidC, "assets/asteroid_c.png");
 
         allocated = true;
     }
-    else // reuse already allocated memory
-    {
-        defaults.rocks = game.rocks;
-        defaults.sounds = game.sounds;
-
-        defaults.ship.soundExplode = game.ship.soundExplode;
-        defaults.ship.soundShoot = game.ship.soundShoot;
-        defaults.textures = game.textures;
-    }
+    world.events.count = 0;
 
+    unsigned int seed = game.seed; // set before with SetGameSeed(), or 0
     game = defaults;
+    SetGameSeed(seed);
+
+    // Generate random stars, the same ones each time for a seed
+    RandomStream *starRandom = &game.random[RANDOM_STREAM_STARS];
+    for (unsigned int i = 0; i < STAR_AMOUNT; i++)
+    {
+        game.stars[i].x = (float)GetRandomInt(starRandom, 0, VIRTUAL_WIDTH);
+        game.stars[i].y = (float)GetRandomInt(starRandom, 0, VIRTUAL_HEIGHT);
+    }
+    SetStarfield(game.stars, STAR_AMOUNT);
 }
 
 void InitNewLevel(unsigned int newLevel)
@@ -116,12 +98,20 @@ void InitNewLevel(unsigned int newLevel)
     game.eliminatedCount = 0;
     game.levelFinished = false;
     game.newLevelTimer = NEW_LEVEL_TIMER;
+
+    // Rocks come from the seed of the N-th level started this session (retries
+    // after a game over count too), not from what happened in earlier levels
+    unsigned long long levelSeed = MixRandomSeed(game.seed, game.levelsStarted);
+    game.levelsStarted++;
+    for (unsigned int i = RANDOM_STREAM_ROCK_SPAWN; i < RANDOM_STREAM_COUNT; i++)
+        SeedRandomStream(&game.random[i], levelSeed, i);
+
     if (newLevel == 1)
     {
         game.lives = STARTING_LIVES;
         game.rockCountStartOfLevel = LVL1_ASTEROID_AMOUNT;
         game.ship.position = (Vector2){ VIRTUAL_WIDTH/2, VIRTUAL_HEIGHT/2 };
-        UpdateShipTriangles(&game.ship);
+        game.shipDraw.previousPosition = game.ship.position;
     }
     else
     {
@@ -136,37 +126,95 @@ void InitNewLevel(unsigned int newLevel)
     }
 
     // Create new asteroids
+    // Reserve enough for every rock to split down to small, plus the one splitting
     game.rockLimit = 0;
     game.rockCount = 0;
+    ReserveAsteroids(game.rockCountStartOfLevel*ASTEROID_SPLIT_MAX + 1);
     for (unsigned int i = 0; i < game.rockCountStartOfLevel; i++)
     {
-        unsigned int rockIdx = CreateAsteroidRandom(ASTEROID_SIZE_BIG);
-        Asteroid *newRock = &game.rocks[rockIdx];
-        newRock->isAtScreenEdge = IsCircleOnEdge(newRock->position, newRock->radius);
+        CreateAsteroidRandom(ASTEROID_SIZE_BIG);
     }
     game.rockLimit -= game.rockCountStartOfLevel;
 
-    for (unsigned int i = 0; i < MISSILE_MAX; i++)
-    {
-        game.ship.missiles[i].isExploded = true;
-        game.ship.missiles[i].explosionTimer = 0;
-    }
+    // Room for the live missiles and the ones still showing their explosion
+    game.missileCount = 0;
+    game.missileLiveCount = 0;
+    ReserveMissiles((game.missileLimit > 0)? game.missileLimit*2 : 16);
+
     ui.textFade = 1.0f;
 }
 
 void FreeGameState(void)
 {
-    MemFree(game.rocks);
-    UnloadSound(game.sounds.menu);
-    UnloadSound(game.sounds.explodeSmall);
-    UnloadSound(game.sounds.explodeMedium);
-    UnloadSound(game.sounds.explodeBig);
-    UnloadSound(game.ship.soundExplode);
-    UnloadSound(game.ship.soundShoot);
-    UnloadTexture(game.textures.ship);
-    UnloadTexture(game.textures.asteroidA);
-    UnloadTexture(game.textures.asteroidB);
-    UnloadTexture(game.textures.asteroidC);
+    MemFree(world.rocks.memory);
+    MemFree(world.missiles.memory);
+    MemFree(world.rockGrid.cellRocks);
+    MemFree(world.rockGrid.rockCells);
+    MemFree(world.rockGrid.chunkCells);
+    FreeGameEvents();
+    world = (GameWorld){ 0 };
+    UnloadGameSound(assets.sounds.menu);
+    UnloadGameSound(assets.sounds.explodeSmall);
+    UnloadGameSound(assets.sounds.explodeMedium);
+    UnloadGameSound(assets.sounds.explodeBig);
+    UnloadGameSound(assets.sounds.shipExplode);
+    UnloadGameSound(assets.sounds.shipShoot);
+    UnloadGameTexture(assets.textures.ship);
+    UnloadGameTexture(assets.textures.asteroidA);
+    UnloadGameTexture(assets.textures.asteroidB);
+    UnloadGameTexture(assets.textures.asteroidC);
+}
+
+void SetGameSeed(unsigned int seed)
+{
+    game.seed = seed;
+    game.levelsStarted = 0;
+    for (unsigned int i = 0; i < RANDOM_STREAM_COUNT; i++)
+        SeedRandomStream(&game.random[i], seed, i);
+}
+
+unsigned int GetNextGameSeed(void)
+{
+    return (unsigned int)MixRandomSeed(game.seed, game.levelsStarted);
+}
+
+// Snapshots
+// ----------------------------------------------------------------------------
+void SaveGameSnapshot(GameSnapshot *snapshot)
+{
+    // Room for the whole pools, so any snapshot fits back into them on restore
+    if (snapshot->rockCapacity < world.rockCapacity)
+    {
+        MemFree(snapshot->rocks.memory);
+        AllocAsteroidPool(&snapshot->rocks, world.rockCapacity);
+        snapshot->rockCapacity = world.rockCapacity;
+    }
+    if (snapshot->missileCapacity < world.missileCapacity)
+    {
+        MemFree(snapshot->missiles.memory);
+        AllocMissilePool(&snapshot->missiles, world.missileCapacity);
+        snapshot->missileCapacity = world.missileCapacity;
+    }
+
+    snapshot->state = game;
+    CopyAsteroids(&snapshot->rocks, &world.rocks, game.rockCount);
+    CopyMissiles(&snapshot->missiles, &world.missiles, game.missileCount);
+}
+
+void RestoreGameSnapshot(const GameSnapshot *snapshot)
+{
+    // Pools never shrink, so they're still at least as big as when saved
+    game = snapshot->state;
+    CopyAsteroids(&world.rocks, &snapshot->rocks, game.rockCount);
+    CopyMissiles(&world.missiles, &snapshot->missiles, game.missileCount);
+    world.events.count = 0;
+}
+
+void FreeGameSnapshot(GameSnapshot *snapshot)
+{
+    MemFree(snapshot->rocks.memory);
+    MemFree(snapshot->missiles.memory);
+    *snapshot = (GameSnapshot){ 0 };
 }
 
 // Update & Draw
@@ -174,6 +222,8 @@ void FreeGameState(void)
 
 void UpdateGameFrame(void)
 {
+    SavePreviousTick();
+
     // Detect win state and go to next level
     if (!game.levelFinished && (game.lives > 0) &&
         game.rockLimit == game.eliminatedCount)
@@ -201,7 +251,7 @@ void UpdateGameFrame(void)
             ui.currentMenu = UI_MENU_NONE;
             ui.textFade = previousTextFade;
         }
-        PlaySound(game.sounds.menu);
+        PlayGameSound(assets.sounds.menu);
     }
 
     // Update timers
@@ -225,115 +275,297 @@ void UpdateGameFrame(void)
         }
 
         // Update rocks
-        for (unsigned int i = 0; i < game.rockCount; i++)
-            UpdateAsteroid(i);
+        PROFILE_BEGIN(PROFILE_UPDATE_ROCKS);
+        UpdateAsteroids();
+        PROFILE_END(PROFILE_UPDATE_ROCKS);
+        UpdateCollisionGrid();
 
         // Update bullets
-        for (unsigned int i = 0; i < MISSILE_MAX; i++)
-            UpdateMissile(&game.ship.missiles[i]);
+        UpdateMissiles();
 
         // Update ship
+        PROFILE_BEGIN(PROFILE_UPDATE_SHIP);
         UpdateShip(&game.ship);
+        PROFILE_END(PROFILE_UPDATE_SHIP);
+
+        // Split and remove rocks that were hit, explode the ship, play sounds
+        ApplyGameEvents();
     }
     // Prevent input after resuming pause
-    if (IsMouseButtonUp(MOUSE_LEFT_BUTTON) && game.resumeInputCooldown)
+    if (!input.mouse.leftDown && game.resumeInputCooldown)
         game.resumeInputCooldown = false;
 
     // Update user interface elements and logic
     UpdateUiFrame();
 }
 
+void SavePreviousTick(void)
+{
+    game.shipDraw.previousPosition = game.ship.position;
+    game.shipDraw.previousAngle = game.ship.angle;
+
+    memcpy(world.missiles.previousX, world.missiles.positionX, game.missileCount*sizeof(float));
+    memcpy(world.missiles.previousY, world.missiles.positionY, game.missileCount*sizeof(float));
+
+    memcpy(world.rocks.previousX, world.rocks.positionX, game.rockCount*sizeof(float));
+    memcpy(world.rocks.previousY, world.rocks.positionY, game.rockCount*sizeof(float));
+    memcpy(world.rocks.previousAngle, world.rocks.spriteAngle, game.rockCount*sizeof(float));
+}
+
 void DrawGameFrame(void)
 {
-    // Draw stars
-    for (unsigned int i = 0; i < STAR_AMOUNT; i++)
-        DrawCircleV(game.stars[i], 1.0f, WHITE);
+    // Queue stars
+    QueueStarfield(WHITE);
 
-    // Draw rocks
+    // Queue rocks
     for (unsigned int i = 0; i < game.rockCount; i++)
-    {
-        Asteroid *rock = &game.rocks[i];
-        if (!rock->isExploded)
-            DrawAsteroid(i);
-    }
+        DrawAsteroid(i);
 
-    // Draw missiles
-    for (unsigned int i = 0; i < MISSILE_MAX; i++)
-    {
-        Missile *shot = &game.ship.missiles[i];
-        DrawMissile(shot);
-    }
+    // Queue missiles
+    for (unsigned int i = 0; i < game.missileCount; i++)
+        DrawMissile(i);
+
+    DrawShip(&game.ship, &game.shipDraw);
 
-    DrawShip(&game.ship);
+    // Draw the game world, sorted into as few batches as possible
+    DrawRenderQueue();
 
     // Draw user interface elements
+    PROFILE_BEGIN(PROFILE_DRAW_UI);
     DrawUiFrame();
+    PROFILE_END(PROFILE_DRAW_UI);
 }
 
 // Collision
 // ----------------------------------------------------------------------------
 
-bool IsShipOnEdge(SpaceShip *ship)
+// Get the grid cell of a position, wrapping any position into the world
+static int GetCollisionGridCell(float x, float y)
 {
-    // Check ship
-    for (unsigned int i = 0; i < 3; i++)
+    const float cellWidth = (float)VIRTUAL_WIDTH/COLLISION_GRID_COLUMNS;
+    const float cellHeight = (float)VIRTUAL_HEIGHT/COLLISION_GRID_ROWS;
+    int column = (int)floorf(x/cellWidth) % COLLISION_GRID_COLUMNS;
+    int row = (int)floorf(y/cellHeight) % COLLISION_GRID_ROWS;
+    if (column < 0) column += COLLISION_GRID_COLUMNS;
+    if (row < 0) row += COLLISION_GRID_ROWS;
+
+    return row*COLLISION_GRID_COLUMNS + column;
+}
+
+// Job: find the cell of each rock in a chunk, and count the chunk's rocks per cell
+static void CountCollisionGridChunk(void *data, unsigned int first, unsigned int last, unsigned int chunkIdx)
+{
+    CollisionGrid *grid = data;
+    unsigned int *cellCounts = &grid->chunkCells[chunkIdx*COLLISION_GRID_CELLS];
+    for (unsigned int i = 0; i < COLLISION_GRID_CELLS; i++)
+        cellCounts[i] = 0;
+    for (unsigned int i = first; i < last; i++)
     {
-        Vector2 shipPoint = ship->shipPoints[i];
-        Vector2 jetPoint = ship->jetPoints[i];
-        if ((shipPoint.x < 0) || (shipPoint.x > VIRTUAL_WIDTH) ||
-            (shipPoint.y < 0) || (shipPoint.y > VIRTUAL_HEIGHT)||
-            (jetPoint.x < 0) || (jetPoint.x > VIRTUAL_WIDTH) ||
-            (jetPoint.y < 0) || (jetPoint.y > VIRTUAL_HEIGHT))
-                return true; // At least one point is past the edge
+        unsigned int cell = (unsigned int)GetCollisionGridCell(world.rocks.positionX[i], world.rocks.positionY[i]);
+        grid->rockCells[i] = cell;
+        cellCounts[cell]++;
     }
+}
 
-    // Ship is not past edge
-    return false;
+// Job: place a chunk's rocks in their cells, after the rocks of earlier chunks
+static void PlaceCollisionGridChunk(void *data, unsigned int first, unsigned int last, unsigned int chunkIdx)
+{
+    CollisionGrid *grid = data;
+    unsigned int *cellNext = &grid->chunkCells[chunkIdx*COLLISION_GRID_CELLS];
+    for (unsigned int i = first; i < last; i++)
+        grid->cellRocks[cellNext[grid->rockCells[i]]++] = i;
 }
 
-bool IsCircleOnEdge(Vector2 position, float radius)
+void UpdateCollisionGrid(void)
 {
-    if ((position.x - radius < 0) ||
-        (position.x + radius > VIRTUAL_WIDTH) ||
-        (position.y - radius < 0) ||
-        (position.y + radius > VIRTUAL_HEIGHT))
-        return true; // Circular object is past the edge
+    CollisionGrid *grid = &world.rockGrid;
+    unsigned int chunkCount = GetJobChunkCount(game.rockCount, COLLISION_GRID_CHUNK);
 
-    // Circular object is not past edge
-    return false;
+    // Only allocates when the rock pool has grown
+    if (grid->capacity < world.rockCapacity)
+    {
+        grid->cellRocks = MemRealloc(grid->cellRocks, world.rockCapacity*sizeof(unsigned int));
+        grid->rockCells = MemRealloc(grid->rockCells, world.rockCapacity*sizeof(unsigned int));
+        grid->capacity = world.rockCapacity;
+    }
+    if (grid->chunkCapacity < chunkCount)
+    {
+        grid->chunkCells = MemRealloc(grid->chunkCells, chunkCount*COLLISION_GRID_CELLS*sizeof(unsigned int));
+        grid->chunkCapacity = chunkCount;
+    }
+
+    // Count rocks per cell
+    RunParallelFor(game.rockCount, COLLISION_GRID_CHUNK, CountCollisionGridChunk, grid);
+
+    // Turn counts into where each cell starts, and where each chunk starts within it
+    unsigned int next = 0;
+    for (unsigned int cell = 0; cell < COLLISION_GRID_CELLS; cell++)
+    {
+        grid->cellStart[cell] = next;
+        for (unsigned int chunk = 0; chunk < chunkCount; chunk++)
+        {
+            unsigned int *chunkCell = &grid->chunkCells[chunk*COLLISION_GRID_CELLS + cell];
+            unsigned int count = *chunkCell;
+            *chunkCell = next;
+            next += count;
+        }
+    }
+    grid->cellStart[COLLISION_GRID_CELLS] = next;
+
+    // Place rocks in their cells, in index order like a serial pass would
+    RunParallelFor(game.rockCount, COLLISION_GRID_CHUNK, PlaceCollisionGridChunk, grid);
 }
 
-bool CheckCollisionAsteroidShip(unsigned int rockIdx, SpaceShip *ship)
+unsigned int GetCollisionGridCells(Vector2 position, float reach, unsigned int *cells)
 {
-    Asteroid *rock = &game.rocks[rockIdx];
-
-    // Check each point
-    for (unsigned int i = 0; i < 3; i++)
+    const float cellWidth = (float)VIRTUAL_WIDTH/COLLISION_GRID_COLUMNS;
+    const float cellHeight = (float)VIRTUAL_HEIGHT/COLLISION_GRID_ROWS;
+    int firstColumn = (int)floorf((position.x - reach)/cellWidth);
+    int lastColumn = (int)floorf((position.x + reach)/cellWidth);
+    int firstRow = (int)floorf((position.y - reach)/cellHeight);
+    int lastRow = (int)floorf((position.y + reach)/cellHeight);
+
+    // Don't visit a cell twice when the reach wraps all the way around
+    if (lastColumn - firstColumn >= COLLISION_GRID_COLUMNS)
+        lastColumn = firstColumn + COLLISION_GRID_COLUMNS - 1;
+    if (lastRow - firstRow >= COLLISION_GRID_ROWS)
+        lastRow = firstRow + COLLISION_GRID_ROWS - 1;
+
+    unsigned int cellCount = 0;
+    for (int row = firstRow; row <= lastRow; row++)
     {
-        Vector2 shipPoint = Vector2Rotate(game.shipTriangle[i], ship->angle*DEG2RAD);
-        shipPoint = Vector2Add(shipPoint, ship->position);
-        if (CheckCollisionPointCircle(shipPoint, rock->position, rock->radius))
-            return true;
+        int wrappedRow = ((row % COLLISION_GRID_ROWS) + COLLISION_GRID_ROWS) % COLLISION_GRID_ROWS;
+        for (int column = firstColumn; column <= lastColumn; column++)
+        {
+            int wrappedColumn = ((column % COLLISION_GRID_COLUMNS) + COLLISION_GRID_COLUMNS) % COLLISION_GRID_COLUMNS;
+            cells[cellCount++] = (unsigned int)(wrappedRow*COLLISION_GRID_COLUMNS + wrappedColumn);
+        }
     }
 
-    if (rock->isAtScreenEdge)
+    return cellCount;
+}
+
+Rectangle GetCircleBounds(Vector2 center, float radius)
+{
+    return (Rectangle){ center.x - radius, center.y - radius, radius*2, radius*2 };
+}
+
+unsigned int GetWrapCloneOffsets(Rectangle bounds, Vector2 *offsets)
+{
+    // Each side of the screen the bounds cross shows a copy from the tile on
+    // the opposite side, plus the corner tile when crossing on both axes
+    float offsetsX[3] = { 0 };
+    float offsetsY[3] = { 0 };
+    unsigned int countX = 1;
+    unsigned int countY = 1;
+    if (bounds.x < 0) offsetsX[countX++] = VIRTUAL_WIDTH;
+    if (bounds.x + bounds.width > VIRTUAL_WIDTH) offsetsX[countX++] = -VIRTUAL_WIDTH;
+    if (bounds.y < 0) offsetsY[countY++] = VIRTUAL_HEIGHT;
+    if (bounds.y + bounds.height > VIRTUAL_HEIGHT) offsetsY[countY++] = -VIRTUAL_HEIGHT;
+
+    unsigned int count = 0;
+    for (unsigned int y = 0; y < countY; y++)
     {
-        for (unsigned int o = 0; o < 8; o++)
+        for (unsigned int x = 0; x < countX; x++)
         {
-            Vector2 cloneRockPos = Vector2Add(rock->position, game.wrapOffsets[o]);
-            for (unsigned int i = 0; i < 3; i++)
-            {
-                Vector2 shipPoint = Vector2Rotate(game.shipTriangle[i], ship->angle*DEG2RAD);
-                shipPoint = Vector2Add(shipPoint, ship->position);
-                if (CheckCollisionPointCircle(shipPoint, cloneRockPos, rock->radius))
-                    return true;
-            }
+            if ((x > 0) || (y > 0)) // not the original
+                offsets[count++] = (Vector2){ offsetsX[x], offsetsY[y] };
         }
     }
 
+    return count;
+}
+
+// The game world wraps around, so any two points are also apart by the
+// offset to the other point's copy on the opposite side of the screen
+Vector2 GetWrappedDelta(Vector2 from, Vector2 to)
+{
+    Vector2 delta = Vector2Subtract(to, from);
+    delta.x -= VIRTUAL_WIDTH*roundf(delta.x/VIRTUAL_WIDTH);
+    delta.y -= VIRTUAL_HEIGHT*roundf(delta.y/VIRTUAL_HEIGHT);
+    return delta;
+}
+
+bool CheckCollisionCirclesWrapped(Vector2 center1, float radius1, Vector2 center2, float radius2)
+{
+    Vector2 delta = GetWrappedDelta(center1, center2);
+    float radiusSum = radius1 + radius2;
+    return (Vector2LengthSqr(delta) <= radiusSum*radiusSum);
+}
+
+bool CheckCollisionPointCircleWrapped(Vector2 point, Vector2 center, float radius)
+{
+    return CheckCollisionCirclesWrapped(point, 0.0f, center, radius);
+}
+
+bool CheckCollisionCirclesSwept(Vector2 start1, Vector2 end1, float radius1, Vector2 start2, Vector2 end2, float radius2, float *hitTime)
+{
+    // Seen from circle 2, circle 1 moves in a straight line from offset to
+    // offset + step, each move is its shortest way past screen edges
+    Vector2 offset = GetWrappedDelta(start2, start1);
+    Vector2 step = Vector2Subtract(GetWrappedDelta(start1, end1), GetWrappedDelta(start2, end2));
+    float radiusSum = radius1 + radius2;
+
+    // Solve |offset + step*t| = radiusSum for the first t in 0..1
+    float c = Vector2DotProduct(offset, offset) - radiusSum*radiusSum;
+    if (c <= 0.0f) // already touching
+    {
+        if (hitTime != NULL) *hitTime = 0.0f;
+        return true;
+    }
+    float b = Vector2DotProduct(offset, step);
+    if (b >= 0.0f) // moving apart, or not moving at all
+        return false;
+    float a = Vector2DotProduct(step, step);
+    float discriminant = b*b - a*c;
+    if (discriminant < 0.0f) // passes by without touching
+        return false;
+    float time = (-b - sqrtf(discriminant))/a;
+    if (time > 1.0f) // doesn't get there this tick
+        return false;
+
+    if (hitTime != NULL) *hitTime = time;
+    return true;
+}
+
+bool CheckCollisionAsteroidShip(unsigned int rockIdx, const SpaceShipHull *hull)
+{
+    Vector2 rockStart = { world.rocks.previousX[rockIdx], world.rocks.previousY[rockIdx] };
+    Vector2 rockEnd = { world.rocks.positionX[rockIdx], world.rocks.positionY[rockIdx] };
+    float rockRadius = world.rocks.radius[rockIdx];
+
+    // Bounding circle, most nearby rocks stop here
+    if (!CheckCollisionCirclesSwept(hull->previousCenter, hull->center, hull->radius + COLLISION_MARGIN,
+                                    rockStart, rockEnd, rockRadius, NULL))
+        return false;
+
+    // Bounding box, against where the rock's copy nearest the ship went
+    Vector2 nearestEnd = Vector2Add(hull->center, GetWrappedDelta(hull->center, rockEnd));
+    Vector2 nearestStart = Vector2Subtract(nearestEnd, GetWrappedDelta(rockStart, rockEnd));
+    float boxReach = rockRadius + COLLISION_MARGIN;
+    Vector2 min = Vector2SubtractValue(Vector2Min(nearestStart, nearestEnd), boxReach);
+    Vector2 max = Vector2AddValue(Vector2Max(nearestStart, nearestEnd), boxReach);
+    if ((max.x < hull->bounds.x) || (min.x > hull->bounds.x + hull->bounds.width) ||
+        (max.y < hull->bounds.y) || (min.y > hull->bounds.y + hull->bounds.height))
+        return false;
+
+    // Check the path of each point
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        if (CheckCollisionCirclesSwept(hull->previousPoints[i], hull->points[i], 0.0f, rockStart, rockEnd, rockRadius, NULL))
+            return true;
+    }
+
     return false;
 }
 
+bool CheckCollisionAsteroidMissile(unsigned int rockIdx, Vector2 missileStart, Vector2 missileEnd, float *hitTime)
+{
+    Vector2 rockStart = { world.rocks.previousX[rockIdx], world.rocks.previousY[rockIdx] };
+    Vector2 rockEnd = { world.rocks.positionX[rockIdx], world.rocks.positionY[rockIdx] };
+    return CheckCollisionCirclesSwept(missileStart, missileEnd, MISSILE_RADIUS, rockStart, rockEnd, world.rocks.radius[rockIdx], hitTime);
+}
+
 void WrapPastEdge(Vector2 *position)
 {
     if (position->x < 0)            // past left edge
@@ -345,3 +577,21 @@ void WrapPastEdge(Vector2 *position)
     if (position->y > VIRTUAL_HEIGHT) // past bottom edge
         position->y -= VIRTUAL_HEIGHT;
 }
+
+// Drawing between ticks
+// ----------------------------------------------------------------------------
+
+Vector2 GetTickBlendPosition(Vector2 previous, Vector2 current)
+{
+    // Blend towards the previous position's nearest copy, so something that
+    // just wrapped moves past the edge instead of across the whole screen
+    Vector2 delta = GetWrappedDelta(current, previous);
+    return Vector2Add(current, Vector2Scale(delta, 1.0f - game.tickBlend));
+}
+
+float GetTickBlendAngle(float previous, float current)
+{
+    float delta = previous - current;
+    delta -= 360.0f*roundf(delta/360.0f);
+    return current + delta*(1.0f - game.tickBlend);
+}
@@ -0,0 +1,216 @@
+// EXPLANATION:
+// Entry point for the headless build, runs the game simulation with no window,
+// GPU or audio device, for profiling and soak testing game logic
+// - Assets come from null_assets.c, so nothing is loaded or played
+// - Time and input are synthetic: fixed ticks and a seeded random "player",
+//   or the input of a recorded session (see replay.h), played as fast as possible
+//
+// Usage: asteroids_headless [ticks] [seed] [workers]
+//        asteroids_headless --replay FILE [workers]
+// Results are the same for any number of worker threads (0 runs everything on one thread)
+// Exits with 1 if the game state breaks an invariant (see CheckGameState())
+
+#include <stdio.h>  // for printf
+#include <stdlib.h> // for strtoul
+#include <string.h> // for strcmp
+#include <time.h>   // for clock, CPU time spent simulating
+
+#include "raylib.h"
+
+#include "config.h"
+#include "input.h"
+#include "ui.h"
+#include "game.h"
+#include "jobs.h"
+#include "replay.h"
+
+#define HEADLESS_DEFAULT_TICKS 100000 // about 14 minutes of gameplay
+#define HEADLESS_INTENT_TICKS 30 // how long the fake player keeps doing the same thing
+
+// Globals
+// ----------------------------------------------------------------------------
+GameState  game;
+GameAssets assets;
+GameWorld  world;
+InputState input;
+UiState    ui;
+
+// Local Functions Declaration
+// ----------------------------------------------------------------------------
+static unsigned int GetNextRandom(unsigned int *state); // xorshift, kept apart from raylib's generator
+static void SetSyntheticInput(unsigned int tick, unsigned int *randomState); // Play like a (not very good) player
+static bool CheckGameState(unsigned int tick); // Returns false and prints why if the game state is broken
+static unsigned long long HashBytes(unsigned long long hash, const void *data, size_t size);
+static unsigned long long GetGameStateHash(void); // Hash of things that should match between runs with the same seed
+
+// Main entry point
+// ----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    // A replay takes the place of ticks and seed
+    bool replay = (argc > 2) && !strcmp(argv[1], "--replay");
+    int argOffset = replay? 1 : 0;
+    unsigned int tickCount = (argc > 1)? (unsigned int)strtoul(argv[1], NULL, 10) : HEADLESS_DEFAULT_TICKS;
+    unsigned int seed = (argc > 2)? (unsigned int)strtoul(argv[2], NULL, 10) : 1;
+    unsigned int workerCount = (argc > 3 + argOffset)? (unsigned int)strtoul(argv[3 + argOffset], NULL, 10) : GetProcessorCount() - 1;
+    unsigned int randomState = seed*2654435761u + 1; // never 0
+
+    // Initialization (no InitWindow or InitAudioDevice)
+    // ----------------------------------------------------------------------------
+    SetTraceLogLevel(LOG_WARNING);
+    if (replay)
+    {
+        if (!LoadReplay(argv[2]))
+        {
+            printf("can't read replay %s\n", argv[2]);
+            return 1;
+        }
+        tickCount = GetReplayTickCount();
+    }
+    else SetGameSeed(seed);
+    InitJobSystem(workerCount);
+    InitDefaultInputSettings();
+    InitUiState();
+    InitGameState(SCREEN_TITLE);
+    ChangeUiMenu(UI_MENU_NONE); // same as pressing start on the title menu (a replay sets its own seed)
+
+    unsigned int levelReached = game.currentLevel;
+    unsigned int shipsLost = 0;
+    unsigned int rocksEliminated = 0;
+    unsigned int rockCountMax = 0;
+
+    // Simulation loop
+    // ----------------------------------------------------------------------------
+    clock_t startTime = clock();
+    unsigned int tick = 0;
+    for (; tick < tickCount; tick++)
+    {
+        unsigned int lives = game.lives;
+        unsigned int eliminated = game.eliminatedCount;
+
+        if (replay)
+            PlayReplayTick(); // also sets frameTime
+        else
+        {
+            SetSyntheticInput(tick, &randomState);
+            game.frameTime = TICK_TIME;
+        }
+        UpdateGameFrame();
+        ConsumeUserInput();
+
+        if (game.lives < lives) shipsLost++;
+        if (game.eliminatedCount > eliminated) rocksEliminated += game.eliminatedCount - eliminated;
+        if (game.currentLevel > levelReached) levelReached = game.currentLevel;
+        if (game.rockCount > rockCountMax) rockCountMax = game.rockCount;
+
+        if (!CheckGameState(tick))
+            break;
+        if (game.currentScreen != SCREEN_GAMEPLAY || game.gameShouldExit)
+        {
+            tick++; // a replay ends like this when its session went back to the title
+            break;
+        }
+    }
+    double seconds = (double)(clock() - startTime)/CLOCKS_PER_SEC;
+
+    // Results
+    // ----------------------------------------------------------------------------
+    printf("ticks:       %u of %u (%.1f game seconds)\n", tick, tickCount, tick*(double)TICK_TIME);
+    printf("workers:     %u\n", GetJobWorkerCount());
+    printf("cpu time:    %.3f s (%.2f us per tick)\n", seconds, (tick > 0)? seconds*1e6/tick : 0.0);
+    printf("level:       %u reached\n", levelReached);
+    printf("ships lost:  %u\n", shipsLost);
+    printf("rocks:       %u eliminated, %u alive at most, pool of %u\n", rocksEliminated, rockCountMax, world.rockCapacity);
+    printf("state hash:  %016llx\n", GetGameStateHash());
+
+    FreeReplay();
+    FreeGameState();
+    FreeUiState();
+    FreeJobSystem();
+
+    return (tick == tickCount)? 0 : 1;
+}
+
+// Local Functions
+// ----------------------------------------------------------------------------
+static unsigned int GetNextRandom(unsigned int *state)
+{
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void SetSyntheticInput(unsigned int tick, unsigned int *randomState)
+{
+    static unsigned int intent = 0;
+    if (tick % HEADLESS_INTENT_TICKS == 0)
+        intent = GetNextRandom(randomState);
+
+    input.player.rotateLeft = ((intent & 3) == 1);
+    input.player.rotateRight = ((intent & 3) == 2);
+    input.player.thrust = ((intent >> 2) % 4 == 0);
+    input.player.shoot = ((intent >> 4) % 8 != 0);
+
+    // Restart after game over
+    input.mouse.tapped = (game.lives == 0);
+}
+
+static bool CheckGameState(unsigned int tick)
+{
+    const char *problem = NULL;
+    const float margin = ASTEROID_RADIUS_BIG; // rocks split this tick haven't wrapped yet
+
+    if (game.rockCount > world.rockCapacity)
+        problem = "more rocks than the pool holds";
+    else if (game.eliminatedCount > game.rockLimit)
+        problem = "more rocks eliminated than the level had";
+    else if (!(game.ship.position.x >= 0 && game.ship.position.x <= VIRTUAL_WIDTH &&
+               game.ship.position.y >= 0 && game.ship.position.y <= VIRTUAL_HEIGHT))
+        problem = "ship outside the world";
+
+    for (unsigned int i = 0; (problem == NULL) && (i < game.rockCount); i++)
+    {
+        float x = world.rocks.positionX[i];
+        float y = world.rocks.positionY[i];
+        if (!(x >= -margin && x <= VIRTUAL_WIDTH + margin && y >= -margin && y <= VIRTUAL_HEIGHT + margin))
+            problem = "rock outside the world";
+        else if (world.rocks.isExploded[i])
+            problem = "exploded rock left in the pool";
+    }
+
+    if (problem != NULL)
+    {
+        printf("tick %u: %s\n", tick, problem);
+        return false;
+    }
+
+    return true;
+}
+
+static unsigned long long HashBytes(unsigned long long hash, const void *data, size_t size)
+{
+    // FNV-1a
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static unsigned long long GetGameStateHash(void)
+{
+    unsigned long long hash = 14695981039346656037ull;
+    hash = HashBytes(hash, &game.ship.position, sizeof(Vector2));
+    hash = HashBytes(hash, &game.ship.angle, sizeof(float));
+    hash = HashBytes(hash, &game.currentLevel, sizeof(unsigned int));
+    hash = HashBytes(hash, &game.lives, sizeof(unsigned int));
+    hash = HashBytes(hash, &game.rockCount, sizeof(unsigned int));
+    hash = HashBytes(hash, world.rocks.positionX, game.rockCount*sizeof(float));
+    hash = HashBytes(hash, world.rocks.positionY, game.rockCount*sizeof(float));
+    return hash;
+}
@@ -0,0 +1,49 @@
+// EXPLANATION:
+// Stand-in for assets.c in the headless build (no window, GPU or audio device)
+// Nothing is loaded or played, textures and sounds are left empty
+
+#include "assets.h"
+
+void QueueGameTexture(Texture *texture, const char *fileName)
+{
+    (void)fileName;
+    *texture = (Texture){ 0 };
+}
+
+void QueueGameSound(Sound *sound, const char *fileName)
+{
+    (void)fileName;
+    *sound = (Sound){ 0 };
+}
+
+void StartAssetLoading(void)
+{
+}
+
+void UpdateAssetLoading(void)
+{
+}
+
+void FinishAssetLoading(void)
+{
+}
+
+bool IsAssetLoadingDone(void)
+{
+    return true;
+}
+
+void UnloadGameTexture(Texture texture)
+{
+    (void)texture;
+}
+
+void UnloadGameSound(Sound sound)
+{
+    (void)sound;
+}
+
+void PlayGameSound(Sound sound)
+{
+    (void)sound;
+}
@@ -0,0 +1,52 @@
+// EXPLANATION:
+// Layout of assets.pak, every texture and sound already decoded into one file
+// - Written at build time by src/tools/packer.c, from the PNG and WAV files in
+//   assets/, then mapped into memory by assets.c (see assets.h)
+// - A header, then an entry per asset, then each asset's data
+// - Textures are RGBA, 8 bits per channel, and sounds are 32 bit float stereo
+//   at ASSET_PACK_SAMPLE_RATE, so the game only uploads them
+// - Numbers are stored as the machine writes them (little endian everywhere
+//   the game builds for), a pack is only read by the version that wrote it
+// - Without a pack (or with an old one) the game loads the files in assets/
+
+#ifndef ASTEROIDS_ASSETPACK_HEADER_GUARD
+#define ASTEROIDS_ASSETPACK_HEADER_GUARD
+
+// Macros
+// ----------------------------------------------------------------------------
+#if !defined(ASSET_PACK_FILE)
+    #define ASSET_PACK_FILE "assets.pak" // CMake builds point this into the build directory
+#endif
+#define ASSET_PACK_MAGIC "APAK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_NAME_SIZE 48 // including the terminator
+#define ASSET_PACK_ALIGNMENT 16 // of each asset's data
+#define ASSET_PACK_SAMPLE_RATE 48000 // what most audio devices run at, raylib converts if it's different
+#define ASSET_PACK_CHANNELS 2
+#define ASSET_PACK_SAMPLE_SIZE 32 // float, raylib's mixing format
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+typedef enum AssetPackType {
+    ASSET_PACK_TEXTURE,
+    ASSET_PACK_SOUND,
+} AssetPackType;
+
+typedef struct AssetPackHeader {
+    char magic[4]; // ASSET_PACK_MAGIC
+    unsigned int version;
+    unsigned int entryCount;
+    unsigned int reserved;
+} AssetPackHeader;
+
+typedef struct AssetPackEntry {
+    char fileName[ASSET_PACK_NAME_SIZE]; // what it was packed from, e.g. "assets/ship.png"
+    unsigned int type; // AssetPackType
+    unsigned int offset; // of the data, from the start of the pack
+    unsigned int size; // of the data in bytes
+    unsigned int width; // texture size in pixels
+    unsigned int height;
+    unsigned int frameCount; // sound length, ASSET_PACK_CHANNELS samples each
+} AssetPackEntry;
+
+#endif // ASTEROIDS_ASSETPACK_HEADER_GUARD
@@ -0,0 +1,37 @@
+// EXPLANATION:
+// Loading, playing and freeing of sounds and textures
+// All game code goes through these instead of calling raylib directly, so a
+// build without a window or audio device can link src/headless/null_assets.c
+// - Assets are queued, then load in the background while the logo plays:
+//   files are read and decoded (PNG/WAV) on a worker thread, and uploaded
+//   (to the GPU or audio device) on the main thread a few per frame
+// - A queued texture or sound stays empty until it's uploaded, so it must
+//   stay where it is (e.g. in a global) until loading is done
+// - On web there are no threads, so decoding also happens a frame at a time
+// - When there's an assets.pak (see assetpack.h) it's mapped instead, and
+//   textures and sounds are made straight from it with no decoding at all
+
+#ifndef ASTEROIDS_ASSETS_HEADER_GUARD
+#define ASTEROIDS_ASSETS_HEADER_GUARD
+
+#include "raylib.h"
+
+// Macros
+// ----------------------------------------------------------------------------
+#define ASSET_QUEUE_MAX 16 // textures and sounds that can be queued at once
+#define ASSET_UPLOADS_PER_FRAME 2 // so no frame of the logo gets long
+
+// Prototypes
+// ----------------------------------------------------------------------------
+
+void QueueGameTexture(Texture *texture, const char *fileName); // Load into texture in the background, left empty if there's no window (OpenGL context)
+void QueueGameSound(Sound *sound, const char *fileName); // Load into sound in the background, left empty if there's no audio device
+void StartAssetLoading(void); // Start decoding the queued assets on a worker thread
+void UpdateAssetLoading(void); // Upload a few decoded assets, call once per frame on the main thread
+void FinishAssetLoading(void); // Wait for and upload every asset that's left
+bool IsAssetLoadingDone(void); // Every queued asset is uploaded, UpdateAssetLoading() gets there a few per frame
+void UnloadGameTexture(Texture texture);
+void UnloadGameSound(Sound sound);
+void PlayGameSound(Sound sound);
+
+#endif // ASTEROIDS_ASSETS_HEADER_GUARD
@@ -10,6 +10,8 @@
 #define ASTEROID_RADIUS_MEDIUM 40
 #define ASTEROID_RADIUS_SMALL 20
 #define ASTEROID_SPEED 300.0f
+#define ASTEROID_SPLIT_MAX 4 // most rocks alive at once from one big asteroid (4 small)
+#define ASTEROID_JOB_CHUNK 4096 // rocks moved per job, must be a multiple of 8 (SIMD batches)
 
 // Types and Structures
 // ----------------------------------------------------------------------------
@@ -20,31 +22,46 @@ typedef enum SizeOfAsteroid {
     ASTEROID_SIZE_BIG,
 } SizeOfAsteroid;
 
-typedef struct Asteroid {
-    Sound *soundExplode;
-    Texture *sprite;
-    Color color;
-    Vector2 position;
-    Vector2 velocity;
-    float angle;
-    float spriteAngle;
-    float speed;
-    float radius;
-    SizeOfAsteroid size;
-    bool isAtScreenEdge;
-    bool rotateLeft;
-    bool isExploded;
-} Asteroid;
+// Rocks are stored as a structure of arrays, all carved out of one memory block
+// Hot data (moved every frame by UpdateAsteroids) is kept apart from the rest
+typedef struct AsteroidPool {
+    void *memory;
+
+    // Hot
+    float *positionX;
+    float *positionY;
+    float *velocityX; // units per second, set from angle and speed at creation
+    float *velocityY;
+    float *spriteAngle;
+    float *spriteSpin; // sprite rotation per tick, negative rotates left
+
+    // Last tick, for drawing between ticks and swept collision
+    float *previousX;
+    float *previousY;
+    float *previousAngle;
+
+    // Cold
+    float *radius;
+    Color *color;
+    unsigned char *size; // SizeOfAsteroid
+    bool *isExploded;
+} AsteroidPool;
 
 // Prototypes
 // ----------------------------------------------------------------------------
 
+void ReserveAsteroids(unsigned int capacity); // Grow the rock pool, only allocates if capacity is larger
+void AllocAsteroidPool(AsteroidPool *rocks, unsigned int capacity); // Allocate arrays for capacity rocks, in one block (freed with MemFree(rocks->memory))
+void CopyAsteroids(AsteroidPool *dest, const AsteroidPool *source, unsigned int count); // Copy the first count rocks
 unsigned int CreateAsteroid(SizeOfAsteroid size, Vector2 position, float angle, Color color);
 unsigned int CreateAsteroidRandom(SizeOfAsteroid size);
 Color ColorBrightnessVariation(Color color);
-void SplitAsteroid(unsigned int rockIdx);
-void UpdateAsteroid(unsigned int rockIdx);
-void DrawAsteroid(unsigned int rockIdx);
+void SplitAsteroid(unsigned int rockIdx); // Queue two smaller rocks in its place (see events.h)
+void DestroyAsteroid(unsigned int rockIdx); // Swap-remove, the last rock moves into rockIdx
+void UpdateAsteroids(void); // Move and spin every rock, in SIMD batches of 8 where available, split across job threads
+void DrawAsteroid(unsigned int rockIdx); // Queue the rock and its clones (see render.h)
+Texture *GetAsteroidSprite(SizeOfAsteroid size);
+Sound *GetAsteroidSound(SizeOfAsteroid size);
 
 #endif // ASTEROIDS_ASTEROID_HEADER_GUARD
 
@@ -0,0 +1,45 @@
+// EXPLANATION:
+// Small set of atomic operations and thread-local storage, for code shared
+// between threads (profiler events, job queues)
+// - Loads acquire and stores release, read-modify-writes are sequentially consistent
+// - Fences order the plain reads and writes around them, where an acquire load
+//   or release store alone doesn't (e.g. the profiler's sequence numbers)
+// - Only for 32 bit unsigned ints
+
+#ifndef ASTEROIDS_ATOMICS_HEADER_GUARD
+#define ASTEROIDS_ATOMICS_HEADER_GUARD
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #define AtomicLoad(ptr) ((unsigned int)_InterlockedOr((volatile long *)(ptr), 0))
+    #define AtomicStore(ptr, value) ((void)_InterlockedExchange((volatile long *)(ptr), (long)(value)))
+    #define AtomicExchange(ptr, value) ((unsigned int)_InterlockedExchange((volatile long *)(ptr), (long)(value)))
+    #define AtomicFetchAdd(ptr, value) ((unsigned int)_InterlockedExchangeAdd((volatile long *)(ptr), (long)(value)))
+    #define AtomicFetchSub(ptr, value) ((unsigned int)_InterlockedExchangeAdd((volatile long *)(ptr), -(long)(value)))
+    #define CpuRelax() _mm_pause()
+    #if defined(_M_ARM64) || defined(_M_ARM)
+        #define AtomicFenceAcquire() __dmb(0xB) // full barrier (ISH)
+        #define AtomicFenceRelease() __dmb(0xB)
+    #else
+        // x86 only lets later loads pass earlier stores, so just stop the compiler
+        #define AtomicFenceAcquire() _ReadWriteBarrier()
+        #define AtomicFenceRelease() _ReadWriteBarrier()
+    #endif
+    #define THREAD_LOCAL __declspec(thread)
+#else
+    #define AtomicLoad(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+    #define AtomicStore(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+    #define AtomicExchange(ptr, value) __atomic_exchange_n((ptr), (value), __ATOMIC_SEQ_CST)
+    #define AtomicFetchAdd(ptr, value) __atomic_fetch_add((ptr), (value), __ATOMIC_SEQ_CST)
+    #define AtomicFetchSub(ptr, value) __atomic_fetch_sub((ptr), (value), __ATOMIC_SEQ_CST)
+    #define AtomicFenceAcquire() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+    #define AtomicFenceRelease() __atomic_thread_fence(__ATOMIC_RELEASE)
+    #if defined(__i386__) || defined(__x86_64__)
+        #define CpuRelax() __builtin_ia32_pause()
+    #else
+        #define CpuRelax() ((void)0)
+    #endif
+    #define THREAD_LOCAL __thread
+#endif
+
+#endif // ASTEROIDS_ATOMICS_HEADER_GUARD
@@ -16,8 +16,27 @@
 #define INITIAL_HEIGHT 720 // Default size of the game window
 #define INITIAL_WIDTH (int)(INITIAL_HEIGHT*ASPECT_RATIO)
 
-// there may be small bugs with very high FPS (uncapped + no vsync), but should work fine overall
 #define MAX_FRAMERATE 120 // Set to 0 for uncapped framerate
 #define VSYNC_ENABLED true
 
+// Gameplay runs in fixed steps no matter the framerate, drawing blends between the last two
+#define TICK_RATE 120 // Simulation steps per second
+#define TICK_TIME (1.0f/TICK_RATE)
+#define TICK_MAX_CATCHUP 8 // Most steps run in one frame, after a long frame the rest is dropped
+
+#define PROFILER_ENABLED 1 // Set to 0 to compile out the profiler zones (see profiler.h)
+#define DRAW_STATS_ENABLED 1 // Set to 0 to draw without counting draw calls and batch flushes (see drawstats.h)
+
+// Memory layout of data the simulation goes through every tick
+#define CACHE_LINE_SIZE 64
+#if defined(_MSC_VER)
+    #define CACHE_ALIGNED __declspec(align(64)) // put before a declaration
+#else
+    #define CACHE_ALIGNED __attribute__((aligned(CACHE_LINE_SIZE)))
+#endif
+
+// Compile time check, C99 has no _Static_assert so a false condition makes
+// an array of negative size
+#define STATIC_ASSERT(condition, name) typedef char static_assert_##name[(condition)? 1 : -1]
+
 #endif // ASTEROIDS_CONFIG_HEADER_GUARD
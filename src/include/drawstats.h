@@ -0,0 +1,81 @@
+// EXPLANATION:
+// Counts what drawing costs each frame: GPU draw calls, batch flushes,
+// vertices and texture changes
+// - Files that include this header have their raylib draw calls routed through
+//   counting wrappers (see the macros below), the wrappers follow raylib's
+//   batching rules to work out when a draw call or flush happens
+// - The counts are an estimate: they come from a copy of the batching in the
+//   bundled rlgl.h (new draws, vertex padding, flushes), not from rlgl itself,
+//   so they can drift after a raylib update, and drawing without a wrapper
+//   isn't counted
+// - Counts only depend on what was drawn, so they're the same on every run and
+//   can be compared between builds (see the bench's --draw and --check modes)
+// - Set DRAW_STATS_ENABLED to 0 in config.h to draw without counting
+
+#ifndef ASTEROIDS_DRAWSTATS_HEADER_GUARD
+#define ASTEROIDS_DRAWSTATS_HEADER_GUARD
+
+#include "raylib.h" // before the macros, so raylib's own declarations aren't renamed
+#include "config.h"
+
+// Macros
+// ----------------------------------------------------------------------------
+#define DRAW_STATS_SCREENS 3 // logo, title, gameplay (see ScreenState)
+
+#if DRAW_STATS_ENABLED && !defined(DRAW_STATS_IMPLEMENTATION)
+    #define BeginMode2D          CountedBeginMode2D
+    #define EndMode2D            CountedEndMode2D
+    #define BeginScissorMode     CountedBeginScissorMode
+    #define EndScissorMode       CountedEndScissorMode
+    #define BeginTextureMode     CountedBeginTextureMode
+    #define EndTextureMode       CountedEndTextureMode
+    #define EndDrawing           CountedEndDrawing
+    #define DrawFPS              CountedDrawFPS
+    #define DrawText             CountedDrawText
+    #define DrawTexturePro       CountedDrawTexturePro
+    #define DrawTextureEx        CountedDrawTextureEx
+    #define DrawCircleV          CountedDrawCircleV
+    #define DrawTriangle         CountedDrawTriangle
+    #define DrawRectangle        CountedDrawRectangle
+    #define DrawRectangleLinesEx CountedDrawRectangleLinesEx
+    #define DrawRing             CountedDrawRing
+    #define DrawLine             CountedDrawLine
+#endif
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+typedef struct DrawStats {
+    unsigned int drawCalls; // one per run of the same texture and primitive type
+    unsigned int batchFlushes; // times a batch is sent to the GPU
+    unsigned int vertices; // sent to the GPU, with the padding added when the primitive type changes
+    unsigned int textureChanges; // draw calls with a different texture from the one before (rlgl binds one for every draw call)
+} DrawStats;
+
+// Prototypes
+// ----------------------------------------------------------------------------
+void BeginDrawStatsFrame(void); // Start counting a frame, call after BeginDrawing()
+void EndDrawStatsFrame(int screen); // Finish the frame's counts (after EndDrawing()), adds them to the screen's totals
+DrawStats GetDrawStats(void); // Counts for the last finished frame
+DrawStats GetScreenDrawStats(int screen); // Average counts per frame on a screen (ScreenState)
+void SetDrawStatsBatchSize(unsigned int elements); // Switching render batch flushes, elements is the new batch's quad capacity
+
+// Counting wrappers, same as the raylib functions they're named after
+void CountedBeginMode2D(Camera2D camera);
+void CountedEndMode2D(void);
+void CountedBeginScissorMode(int x, int y, int width, int height);
+void CountedEndScissorMode(void);
+void CountedBeginTextureMode(RenderTexture2D target);
+void CountedEndTextureMode(void);
+void CountedEndDrawing(void);
+void CountedDrawFPS(int posX, int posY);
+void CountedDrawText(const char *text, int posX, int posY, int fontSize, Color color);
+void CountedDrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+void CountedDrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint);
+void CountedDrawCircleV(Vector2 center, float radius, Color color);
+void CountedDrawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color);
+void CountedDrawRectangle(int posX, int posY, int width, int height, Color color);
+void CountedDrawRectangleLinesEx(Rectangle rec, float lineThick, Color color);
+void CountedDrawRing(Vector2 center, float innerRadius, float outerRadius, float startAngle, float endAngle, int segments, Color color);
+void CountedDrawLine(int startPosX, int startPosY, int endPosX, int endPosY, Color color);
+
+#endif // ASTEROIDS_DRAWSTATS_HEADER_GUARD
@@ -0,0 +1,50 @@
+// EXPLANATION:
+// Queue of things that happen to entities during a tick (hits, splits, sounds)
+// - Update and collision passes only push events, ApplyGameEvents() carries
+//   them out once every update has finished
+// - So update loops never add or remove rocks in the arrays they go through,
+//   and the rock pool only grows between passes
+
+#ifndef ASTEROIDS_EVENTS_HEADER_GUARD
+#define ASTEROIDS_EVENTS_HEADER_GUARD
+
+#include "raylib.h"
+#include "asteroid.h"
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+typedef enum GameEventType {
+    GAME_EVENT_ROCK_DESTROYED, // rock was hit: split it, count it and remove it
+    GAME_EVENT_ROCK_SPAWN,
+    GAME_EVENT_SHIP_HIT,
+    GAME_EVENT_PLAY_SFX,
+} GameEventType;
+
+// Only the fields for the event's type are set
+typedef struct GameEvent {
+    GameEventType type;
+    unsigned int rockIdx; // destroyed
+    SizeOfAsteroid size; // spawn
+    Vector2 position; // spawn
+    float angle; // spawn, direction of travel
+    Color color; // spawn
+    Sound *sound; // sfx
+} GameEvent;
+
+typedef struct GameEventQueue {
+    GameEvent *events;
+    unsigned int count;
+    unsigned int capacity; // grows as needed, kept between ticks
+} GameEventQueue;
+
+// Prototypes
+// ----------------------------------------------------------------------------
+void PushGameEvent(GameEvent event);
+void PushRockDestroyed(unsigned int rockIdx); // Also marks the rock, so later passes skip it this tick
+void PushRockSpawn(SizeOfAsteroid size, Vector2 position, float angle, Color color);
+void PushShipHit(void);
+void PushPlaySfx(Sound *sound);
+void ApplyGameEvents(void); // Carry out and clear this tick's events, in the order they were pushed
+void FreeGameEvents(void);
+
+#endif // ASTEROIDS_EVENTS_HEADER_GUARD
@@ -5,9 +5,15 @@
 #define ASTEROIDS_GAME_HEADER_GUARD
 
 #include "raylib.h"
+#include "config.h"
 #include "asteroid.h"
 #include "ship.h"
+#include "missile.h"
 #include "input.h"
+#include "events.h"
+#include "random.h"
+
+#include <stddef.h> // for offsetof in the layout asserts
 
 // Macros
 // ----------------------------------------------------------------------------
@@ -17,6 +23,14 @@
 #define NEW_LEVEL_TIMER 1.5f
 #define GAMEOVER_INPUT_COOLDOWN 1.0f
 #define LVL1_ASTEROID_AMOUNT 2
+#define WRAP_CLONES_MAX 8 // copies of something bigger than the screen, 3 otherwise
+
+// Broadphase grid over the game world, a collision check visits every cell its
+// reach overlaps, so the grid size only changes speed, not what collides
+#define COLLISION_GRID_COLUMNS 16
+#define COLLISION_GRID_ROWS 9
+#define COLLISION_GRID_CELLS (COLLISION_GRID_COLUMNS*COLLISION_GRID_ROWS)
+#define COLLISION_GRID_CHUNK 4096 // rocks per job when building the grid
 
 // Types and Structures
 // ----------------------------------------------------------------------------
@@ -25,11 +39,22 @@ typedef enum ScreenState {
     SCREEN_LOGO, SCREEN_TITLE, SCREEN_GAMEPLAY
 } ScreenState;
 
+// Separate streams, so e.g. drawing more stars doesn't change where rocks spawn
+typedef enum GameRandomStream {
+    RANDOM_STREAM_STARS,      // seeded from the game seed
+    RANDOM_STREAM_ROCK_SPAWN, // position and direction of new rocks, seeded each level
+    RANDOM_STREAM_ROCK_SPLIT, // direction of split rocks, seeded each level
+    RANDOM_STREAM_ROCK_LOOK,  // sprite angle, spin and color, seeded each level
+    RANDOM_STREAM_COUNT
+} GameRandomStream;
+
 typedef struct GameSounds {
     Sound menu;
     Sound explodeSmall;
     Sound explodeMedium;
     Sound explodeBig;
+    Sound shipShoot;
+    Sound shipExplode;
 } GameSounds;
 
 typedef struct GameTextures {
@@ -39,24 +64,60 @@ typedef struct GameTextures {
     Texture asteroidC;
 } GameTextures;
 
-typedef struct GameState {
+// Rocks bucketed by the cell their center is in, rebuilt every frame
+typedef struct CollisionGrid {
+    unsigned int cellStart[COLLISION_GRID_CELLS + 1]; // a cell's rocks are cellRocks[cellStart[cell]] up to cellStart[cell + 1]
+    unsigned int *cellRocks; // rock indices sorted by cell
+    unsigned int *rockCells; // cell of each rock
+    unsigned int *chunkCells; // rocks per cell in each job chunk, then where the chunk's rocks go
+    unsigned int capacity;
+    unsigned int chunkCapacity;
+} CollisionGrid;
+
+// Loaded once, entities refer to them by type or size (e.g. GetAsteroidSprite())
+typedef struct GameAssets {
     GameSounds sounds;
     GameTextures textures;
+} GameAssets;
+
+// Arrays the game state refers to by index, kept out of GameState so it has
+// no pointers and can be copied as it is (see SaveGameSnapshot())
+typedef struct GameWorld {
+    AsteroidPool rocks; // game.rockCount live rocks, kept dense by DestroyAsteroid()
+    unsigned int rockCapacity;
+    MissilePool missiles; // game.missileCount missiles, in the order they were fired
+    unsigned int missileCapacity;
+    CollisionGrid rockGrid; // rebuilt every tick
+    GameEventQueue events; // this tick's hits, splits and sounds
+} GameWorld;
+
+// Plain data only, nothing in here points anywhere
+// The ship is updated every tick, so it starts on its own cache line and
+// what's only used for drawing is kept apart
+typedef struct GameState {
+    CACHE_ALIGNED SpaceShip ship;
+    SpaceShipHull shipHull;
+    SpaceShipDrawState shipDraw;
     Camera2D camera;
-    SpaceShip ship;
-    Asteroid *rocks;
+    RandomStream random[RANDOM_STREAM_COUNT];
     Vector2 stars[STAR_AMOUNT];
     Vector2 shipTriangle[3];
     Vector2 jetTriangle[3];
-    Vector2 wrapOffsets[8];
     ScreenState currentScreen;
+    unsigned int seed; // kept by InitGameState(), see SetGameSeed()
+    unsigned int levelsStarted; // this session, so a retried level gets new rocks
     unsigned int currentLevel;
     unsigned int lives;
     unsigned int rockCountStartOfLevel;
     unsigned int rockCount;
+    unsigned int missileCount; // live missiles and ones still showing their explosion
+    unsigned int missileLiveCount;
+    unsigned int missileLimit; // most live missiles, firing past it replaces the oldest (0 for no limit)
     unsigned int rockLimit;
     unsigned int eliminatedCount;
-    float frameTime;
+    float frameTime; // time to advance by, a fixed TICK_TIME during gameplay
+    float tickAccumulator; // real time not yet simulated
+    float tickBlend; // how far drawing is from the previous tick to the current one (0 to 1)
     float messageTimer;
     float newLevelTimer;
     bool isPaused;
@@ -66,7 +127,21 @@ typedef struct GameState {
     bool debugMode;
 } GameState;
 
+STATIC_ASSERT(sizeof(SpaceShip) <= CACHE_LINE_SIZE, ship_fits_cache_line);
+STATIC_ASSERT(offsetof(GameState, ship) % CACHE_LINE_SIZE == 0, ship_cache_aligned);
+
+// A copy of the game state and its rocks and missiles
+typedef struct GameSnapshot {
+    GameState state;
+    AsteroidPool rocks;
+    unsigned int rockCapacity;
+    MissilePool missiles;
+    unsigned int missileCapacity;
+} GameSnapshot;
+
 extern GameState game; // global declaration
+extern GameAssets assets;
+extern GameWorld world;
 
 // Prototypes
 // ----------------------------------------------------------------------------
@@ -75,16 +150,35 @@ extern GameState game; // global declaration
 void InitGameState(ScreenState screen); // Initialize game data and allocate memory for sounds
 void InitNewLevel(unsigned int newLevel);
 void FreeGameState(void); // Free any allocated memory within game state
+void SetGameSeed(unsigned int seed); // Seed the random streams, the same seed and input play out the same
+unsigned int GetNextGameSeed(void); // Seed for a new session, follows on from the current one
+
+// Snapshots
+void SaveGameSnapshot(GameSnapshot *snapshot); // Copy the game state, only allocates if a pool has grown since the last save
+void RestoreGameSnapshot(const GameSnapshot *snapshot); // Put the game back as it was when saved, never allocates
+void FreeGameSnapshot(GameSnapshot *snapshot);
 
 // Update & Draw
-void UpdateGameFrame(void); // Updates all the game's data and objects for the current frame
+void UpdateGameFrame(void); // Updates all the game's data and objects for one fixed tick
+void SavePreviousTick(void); // Keep positions from before a tick, so drawing can blend from them
 void UpdateGameInput(void); // Updates game based on user input for the current frame
 void DrawGameFrame(void); // Draws all the game's objects for the current frame
 
 // Collision
-bool IsShipOnEdge(SpaceShip *ship);
-bool IsCircleOnEdge(Vector2 position, float radius);
-bool CheckCollisionAsteroidShip(unsigned int rockIdx, SpaceShip *ship);
+void UpdateCollisionGrid(void); // Bucket rocks into grid cells, call after rocks have moved (runs in parallel jobs)
+unsigned int GetCollisionGridCells(Vector2 position, float reach, unsigned int *cells); // Get cells within reach of a position (wraps past edges), returns cell count
+Rectangle GetCircleBounds(Vector2 center, float radius);
+unsigned int GetWrapCloneOffsets(Rectangle bounds, Vector2 *offsets); // Offsets of the copies past screen edges that show on screen, returns count (at most 3, or WRAP_CLONES_MAX for bounds bigger than the screen)
+Vector2 GetWrappedDelta(Vector2 from, Vector2 to); // Shortest offset between two points, going past screen edges if closer
+bool CheckCollisionCirclesWrapped(Vector2 center1, float radius1, Vector2 center2, float radius2);
+bool CheckCollisionPointCircleWrapped(Vector2 point, Vector2 center, float radius);
+bool CheckCollisionCirclesSwept(Vector2 start1, Vector2 end1, float radius1, Vector2 start2, Vector2 end2, float radius2, float *hitTime); // Check two circles moving in straight lines over a tick, hitTime (0..1, can be NULL) is when they first touch
+bool CheckCollisionAsteroidShip(unsigned int rockIdx, const SpaceShipHull *hull); // Rejects far rocks by bounding circle and box before testing the paths of the hull's points
+bool CheckCollisionAsteroidMissile(unsigned int rockIdx, Vector2 missileStart, Vector2 missileEnd, float *hitTime); // Check the missile's path this tick against the rock's
 void WrapPastEdge(Vector2 *position);
 
+// Drawing between ticks
+Vector2 GetTickBlendPosition(Vector2 previous, Vector2 current); // Where to draw something between ticks, follows it past screen edges
+float GetTickBlendAngle(float previous, float current); // Angle in degrees to draw between ticks, turning the short way
+
 #endif // ASTEROIDS_GAME_HEADER_GUARD
@@ -11,6 +11,8 @@
 #define INPUT_MAX_ACTIONS 16 // Maximum number of game actions, e.g. confirm, pause, move up
 #define INPUT_MAX_MAPS 24 // Maximum number of inputs that can be mapped to an action
 #define INPUT_MAX_TOUCH_POINTS 8
+#define INPUT_MAX_DEVICE_INPUTS 64 // Maximum number of different keys (or buttons) mapped to any action, per device
+#define INPUT_MAX_KEY_COMBOS 16 // Maximum number of modifier+key combinations, e.g. alt+enter
 #define INPUT_ANALOG_MENU_DEADZONE 0.5f // Deadzone used for analog stick menu movement
 #define INPUT_TRIGGER_BUTTON_DEADZONE 0.25f // Deadzone used when trigger is used as a button
 
@@ -42,6 +44,7 @@ typedef enum InputAction {
     // global
     INPUT_ACTION_FULLSCREEN,
     INPUT_ACTION_DEBUG,
+    INPUT_ACTION_TRACE,
 
     // menu
     INPUT_ACTION_CONFIRM,
@@ -60,6 +63,7 @@ typedef enum InputAction {
 typedef struct InputActionsGlobal {
     bool fullscreen;
     bool debug;
+    bool saveTrace; // save a profiler trace of recent frames
 } InputActionsGlobal;
 
 typedef struct InputActionsMenu {
@@ -120,6 +124,21 @@ typedef struct GamepadAxisMap {
                     // used to map analog stick or trigger as buttons
 } GamepadAxisMap;
 
+typedef unsigned int InputActionMask; // One bit per InputAction
+
+// A mapped key or button, and the actions it triggers by itself
+typedef struct InputBinding {
+    int code; // KeyboardKey, GamepadButton or MouseButton
+    InputActionMask actions; // none if it's only part of key combos
+} InputBinding;
+
+// Modifier held with a key, e.g. alt+enter
+typedef struct InputKeyCombo {
+    unsigned int modifierIdx; // both index into InputActionTable.keys
+    unsigned int keyIdx;
+    InputActionMask actions;
+} InputKeyCombo;
+
 typedef struct InputActionMaps {
     KeyboardKey key[INPUT_MAX_ACTIONS][INPUT_MAX_MAPS];
     MouseButton mouse[INPUT_MAX_ACTIONS][4];
@@ -127,6 +146,20 @@ typedef struct InputActionMaps {
     GamepadAxisMap gamepadAxis[INPUT_MAX_ACTIONS];
 } InputActionMaps;
 
+// InputActionMaps compiled into one list per device, so each key or button
+// is checked once per frame whatever the number of actions it's mapped to
+typedef struct InputActionTable {
+    InputBinding keys[INPUT_MAX_DEVICE_INPUTS];
+    InputBinding gamepadButtons[INPUT_MAX_DEVICE_INPUTS];
+    InputBinding mouseButtons[INPUT_MAX_DEVICE_INPUTS];
+    InputKeyCombo keyCombos[INPUT_MAX_KEY_COMBOS];
+    unsigned int keyCount;
+    unsigned int gamepadButtonCount;
+    unsigned int mouseButtonCount;
+    unsigned int keyComboCount;
+    InputActionMask axisActions; // actions with a gamepad axis mapped as a button
+} InputActionTable;
+
 // Tracks input data for the current frame
 typedef struct InputState {
     // bools for input actions
@@ -143,13 +176,18 @@ typedef struct InputState {
     int gamepadButtonPressed;
     int touchCount;
     bool touchMode; // enabled when touch points are detected, disabled by any non-touch input
-    bool touchButtonDown[INPUT_MAX_ACTIONS];
-    bool touchButtonPressed[INPUT_MAX_ACTIONS];
-    bool gamepadAxisPressedCurrentFrame[INPUT_MAX_ACTIONS]; // for when an axis is mapped as a button
-    bool gamepadAxisPressedPreviousFrame[INPUT_MAX_ACTIONS];
+    InputActionMask actionsDown; // any device, see SampleInputActions()
+    InputActionMask actionsPressed;
+    InputActionMask mouseActionsDown;
+    InputActionMask mouseActionsPressed;
+    InputActionMask touchActionsDown;
+    InputActionMask touchActionsPressed;
+    InputActionMask axisActionsCurrentFrame; // for when an axis is mapped as a button
+    InputActionMask axisActionsPreviousFrame;
     bool anyGamepadButtonPressed;
     bool anyKeyPressed;
     bool anyInputPressed;
+    bool holdPressed; // keep presses for the next frame, no game tick has used them yet
 } InputState;
 
 extern InputState input;
@@ -159,14 +197,17 @@ extern InputState input;
 
 // Primary
 void InitDefaultInputSettings(void); // Sets the default control settings and mappings
+void CompileInputActionMaps(void); // Build the per-device lookup tables, call after changing mappings
+void SampleInputActions(void); // Check every mapped key and button once, and work out which actions are down/pressed
 void ProcessUserInput(void); // Process all user inputs for the current frame
 void ProcessVirtualGamepad(void); // Process touch screen input buttons
 void CancelUserInput(void); // Cancel all user inputs for the current frame
+void ConsumeUserInput(void); // Clear presses once a game tick has used them, so they only count once
 
 // Input Actions
 bool IsInputKeyModifier(KeyboardKey key);
-bool IsInputActionDown(InputAction action);
-bool IsInputActionAxisDown(InputAction action);
+bool IsInputActionDown(InputAction action); // Action checks use the state from the last SampleInputActions()
+bool IsInputActionAxisDown(InputAction action); // Checks the gamepad axis right away
 bool IsInputActionMouseDown(InputAction action);
 bool IsInputActionPressed(InputAction action);
 bool IsInputActionAxisPressed(InputAction action);
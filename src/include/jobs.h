@@ -0,0 +1,44 @@
+// EXPLANATION:
+// A small work-stealing thread pool for splitting loops over many entities
+// across cores (see RunParallelFor())
+// - A loop is cut into chunks, each thread starts with an equal share of them
+//   and steals from the others when it runs out
+// - The calling thread works too and returns once every chunk has run
+// - Chunks must only write to their own range, or to per-chunk buffers that
+//   are merged afterwards in chunk order, so results don't depend on timing
+// - On web, or with 0 workers, chunks run in order on the calling thread
+// - One background thread can also run a single long task (e.g. loading
+//   assets) next to the pool, it doesn't take part in RunParallelFor()
+
+#ifndef ASTEROIDS_JOBS_HEADER_GUARD
+#define ASTEROIDS_JOBS_HEADER_GUARD
+
+#include "raylib.h"
+
+// Macros
+// ----------------------------------------------------------------------------
+#define JOB_MAX_WORKERS 15 // worker threads, not counting the thread calling RunParallelFor()
+#define JOB_MAX_THREADS (JOB_MAX_WORKERS + 1)
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+// Runs items first up to (not including) last of the chunk at chunkIdx
+typedef void (*JobFunction)(void *data, unsigned int first, unsigned int last, unsigned int chunkIdx);
+
+// Runs on the background thread, shouldn't use the profiler (it isn't one of the pool's threads)
+typedef void (*BackgroundFunction)(void *data);
+
+// Prototypes
+// ----------------------------------------------------------------------------
+void InitJobSystem(unsigned int workerCount); // Start worker threads, 0 runs every job on the calling thread
+void FreeJobSystem(void); // Stop and join the worker threads
+unsigned int GetJobWorkerCount(void);
+unsigned int GetJobThreadIndex(void); // 0 for the main thread, 1 and up for workers
+unsigned int GetProcessorCount(void); // Logical cores, for picking a worker count
+unsigned int GetJobChunkCount(unsigned int count, unsigned int chunkSize);
+void RunParallelFor(unsigned int count, unsigned int chunkSize, JobFunction function, void *data); // Run function over count items in chunks, waits for all of them
+bool StartBackgroundThread(BackgroundFunction function, void *data); // Run function on its own thread, false if it can't (web, failed, or one is already running)
+void WaitBackgroundThread(void); // Wait for the background thread's function to return, does nothing if none was started
+
+#endif // ASTEROIDS_JOBS_HEADER_GUARD
@@ -6,7 +6,7 @@
 // Macros
 // ----------------------------------------------------------------------------
 
-#define MISSILE_MAX 5
+#define MISSILE_LIMIT_DEFAULT 5 // live missiles the ship can have, see game.missileLimit
 #define MISSILE_RADIUS 5.0f
 #define MISSILE_SPEED 700.0f
 #define MISSILE_DESPAWN_TIME 1.25f
@@ -14,22 +14,30 @@
 // Types and Structures
 // ----------------------------------------------------------------------------
 
-typedef struct Missile {
-    Vector2 position;
-    Vector2 velocity;
-    float angle;
-    float speed;
-    float radius;
-    float despawnTimer;
-    float explosionTimer;
-    bool isAtScreenEdge;
-    bool isExploded;
-    bool overheated;
-} Missile;
+// Missiles are stored as a structure of arrays in one memory block, like rocks
+// They stay in the order they were fired, so the oldest live one comes first
+typedef struct MissilePool {
+    void *memory;
+    // Hot
+    float *positionX;
+    float *positionY;
+    float *directionX; // of travel, the ship's velocity is added to it every tick
+    float *directionY;
+    float *despawnTimer;
+    float *explosionTimer; // counts down after exploding, while the explosion shows
+    bool *isExploded;
+    // Last tick, for drawing between ticks and swept collision
+    float *previousX;
+    float *previousY;
+} MissilePool;
 
 // Prototypes
 // ----------------------------------------------------------------------------
-void UpdateMissile(Missile *shot);
-void DrawMissile(Missile *shot);
+void ReserveMissiles(unsigned int capacity); // Grow the missile pool, only allocates if capacity is larger
+void AllocMissilePool(MissilePool *shots, unsigned int capacity); // Allocate arrays for capacity missiles, in one block (freed with MemFree(shots->memory))
+void CopyMissiles(MissilePool *dest, const MissilePool *source, unsigned int count); // Copy the first count missiles
+unsigned int CreateMissile(Vector2 position, float angle); // Fire a missile, replaces the oldest live one at game.missileLimit
+void UpdateMissiles(void); // Move every missile, hit rocks along the way, despawn, then remove the ones that are done
+void DrawMissile(unsigned int missileIdx); // Queue the missile and its clones (see render.h)
 
 #endif // ASTEROIDS_MISSILE_HEADER_GUARD
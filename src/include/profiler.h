@@ -0,0 +1,61 @@
+// EXPLANATION:
+// Lightweight timing of the game loop's stages ("zones")
+// - PROFILE_BEGIN/PROFILE_END record timestamped events into a lock-free ring
+//   buffer, the F3 debug overlay and the chrome://tracing export read from it
+// - Set PROFILER_ENABLED to 0 in config.h to compile the zones out entirely
+
+#ifndef ASTEROIDS_PROFILER_HEADER_GUARD
+#define ASTEROIDS_PROFILER_HEADER_GUARD
+
+#include "raylib.h"
+#include "config.h"
+
+// Macros
+// ----------------------------------------------------------------------------
+#define PROFILER_EVENT_CAPACITY 16384 // must be a power of 2, about 800 frames of events
+#define PROFILER_TRACE_FILE "profile_trace.json" // open with chrome://tracing or ui.perfetto.dev
+
+#if PROFILER_ENABLED
+    #define PROFILE_BEGIN(zone) RecordProfileEvent((zone), false)
+    #define PROFILE_END(zone)   RecordProfileEvent((zone), true)
+#else
+    #define PROFILE_BEGIN(zone) ((void)0)
+    #define PROFILE_END(zone)   ((void)0)
+#endif
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+typedef enum ProfileZone {
+    PROFILE_FRAME, // all of UpdateDrawFrame()
+    PROFILE_INPUT,
+    PROFILE_UPDATE_GAME,
+    PROFILE_UPDATE_ROCKS,
+    PROFILE_UPDATE_SHIP,
+    PROFILE_DRAW_GAME,
+    PROFILE_DRAW_UI,
+    PROFILE_END_DRAWING, // includes waiting for vsync or the target FPS
+    PROFILE_JOB, // one chunk of a RunParallelFor() loop, on any thread
+    PROFILE_ZONE_COUNT
+} ProfileZone;
+
+typedef struct ProfileEvent {
+    unsigned long long time; // nanoseconds, see GetProfilerTicks()
+    unsigned int sequence; // ring buffer index + 1 once written, so readers can skip unfinished events
+    unsigned char zone; // ProfileZone
+    unsigned char thread; // see GetJobThreadIndex()
+    bool isEnd;
+} ProfileEvent;
+
+// Prototypes
+// ----------------------------------------------------------------------------
+double GetProfilerTime(void); // High resolution time in seconds, works without a window
+unsigned long long GetProfilerTicks(void); // Same clock in nanoseconds
+void RecordProfileEvent(ProfileZone zone, bool isEnd); // Use PROFILE_BEGIN/PROFILE_END instead
+const char *GetProfileZoneName(ProfileZone zone);
+
+void UpdateProfilerSnapshot(void); // Copy the ring buffer once, the two functions below read from that copy
+unsigned int GetProfilerFrameTimes(float *frameTimes, unsigned int maxCount); // Milliseconds of recent frames, newest first, returns count
+void GetProfilerZoneTimes(float *zoneTimes); // Milliseconds in each zone on the main thread during the last finished frame (PROFILE_ZONE_COUNT values)
+bool SaveProfilerTrace(const char *fileName); // Write every event in the ring buffer as chrome://tracing JSON, one track per thread
+
+#endif // ASTEROIDS_PROFILER_HEADER_GUARD
@@ -0,0 +1,29 @@
+// EXPLANATION:
+// Seedable random number streams (PCG32), used instead of raylib's single
+// global generator
+// - Each stream is just its own state, so results only depend on the seed and
+//   how many values that stream has given, not on what else used randomness
+// - Streams with the same seed but a different id give unrelated values
+// - A stream must only be used by one thread at a time, give each worker
+//   its own stream rather than sharing one
+// - See GameRandomStream in game.h for the streams the game uses
+
+#ifndef ASTEROIDS_RANDOM_HEADER_GUARD
+#define ASTEROIDS_RANDOM_HEADER_GUARD
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+typedef struct RandomStream {
+    unsigned long long state;
+    unsigned long long increment; // always odd, picks the stream
+} RandomStream;
+
+// Prototypes
+// ----------------------------------------------------------------------------
+void SeedRandomStream(RandomStream *stream, unsigned long long seed, unsigned long long streamId);
+unsigned int GetRandomBits(RandomStream *stream); // Next 32 random bits
+int GetRandomInt(RandomStream *stream, int min, int max); // Random value between min and max (both included), like GetRandomValue()
+float GetRandomFloat(RandomStream *stream); // Random value from 0 up to (not including) 1
+unsigned long long MixRandomSeed(unsigned long long seed, unsigned long long value); // Combine a seed with a value (e.g. a level number) into a new seed
+
+#endif // ASTEROIDS_RANDOM_HEADER_GUARD
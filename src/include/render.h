@@ -0,0 +1,70 @@
+// EXPLANATION:
+// Render queue for the game world, so drawing costs a few GPU batches per
+// frame however many entities there are
+// - Draw functions queue commands instead of drawing right away
+// - DrawRenderQueue() sorts them by layer, then texture and primitive type,
+//   and draws them through a render batch big enough for a typical frame
+// - Within a layer, draw order only depends on texture/type and queue order
+// - The stars never move, so they're baked into a texture the size of the
+//   viewport and drawn as one sprite, however many there are
+
+#ifndef ASTEROIDS_RENDER_HEADER_GUARD
+#define ASTEROIDS_RENDER_HEADER_GUARD
+
+#include "raylib.h"
+
+// Macros
+// ----------------------------------------------------------------------------
+#define RENDER_BATCH_ELEMENTS 16384 // quads per batch buffer, fits thousands of rocks
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+// Back to front
+typedef enum RenderLayer {
+    RENDER_LAYER_STARS,
+    RENDER_LAYER_ROCKS,
+    RENDER_LAYER_MISSILES,
+    RENDER_LAYER_SHIP_JET,
+    RENDER_LAYER_SHIP,
+    RENDER_LAYER_EFFECTS, // explosions, respawn shield
+} RenderLayer;
+
+typedef enum RenderCommandType {
+    RENDER_SPRITE,
+    RENDER_CIRCLE,
+    RENDER_TRIANGLE,
+} RenderCommandType;
+
+typedef struct RenderCommand {
+    unsigned long long sortKey; // layer, texture, type, then queue order
+    RenderCommandType type;
+    Color color;
+    Texture texture; // sprite
+    Rectangle source; // sprite
+    Rectangle dest; // sprite
+    Vector2 points[3]; // triangle, or circle center and sprite origin in points[0]
+    float value; // circle radius or sprite rotation
+} RenderCommand;
+
+typedef struct Starfield {
+    const Vector2 *stars;
+    unsigned int starCount;
+    RenderTexture2D texture; // stars drawn at the viewport's resolution
+    bool isBaked; // texture matches the stars
+} Starfield;
+
+// Prototypes
+// ----------------------------------------------------------------------------
+void InitRenderQueue(void); // Load the render batch, needs a window (draws through raylib's batch otherwise)
+void FreeRenderQueue(void);
+void QueueSprite(RenderLayer layer, Texture texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color color); // Same as DrawTexturePro()
+void QueueCircle(RenderLayer layer, Vector2 center, float radius, Color color); // Same as DrawCircleV()
+void QueueTriangle(RenderLayer layer, Vector2 v1, Vector2 v2, Vector2 v3, Color color); // Same as DrawTriangle()
+void SetStarfield(const Vector2 *stars, unsigned int starCount); // Stars to draw as the background, baked again on the next update
+void UpdateStarfield(int width, int height); // Bake the stars if they or the viewport size changed, call before BeginDrawing()
+void QueueStarfield(Color tint); // Queue the baked stars as one sprite (or each star if there's no texture)
+void DrawStarfield(Color tint); // Same as QueueStarfield() but draws right away, for the title screen
+void DrawRenderQueue(void); // Sort and draw everything queued this frame, then empty the queue
+
+#endif // ASTEROIDS_RENDER_HEADER_GUARD
@@ -0,0 +1,73 @@
+// EXPLANATION:
+// Records the input each gameplay tick sees, and plays it back, so a session
+// runs again exactly the same (e.g. as a benchmark or to reproduce a bug)
+// - A session starts when gameplay starts from the title screen, the game's
+//   seed is saved with the replay (see SetGameSeed()) and set again to play it
+// - Each tick stores the action bits, mouse and gamepad axes and frame time,
+//   only the fields that changed are written (as varints), and runs of ticks
+//   where nothing changed are written as a count
+// - Recording is off unless asked for: asteroids --record [FILE]
+// - Play a replay with the headless build: asteroids_headless --replay FILE
+// - Touch points aren't recorded, so touch input doesn't replay
+
+#ifndef ASTEROIDS_REPLAY_HEADER_GUARD
+#define ASTEROIDS_REPLAY_HEADER_GUARD
+
+#include "raylib.h"
+
+// Macros
+// ----------------------------------------------------------------------------
+#define REPLAY_FILE "replay.bin" // last gameplay session, when --record is given without a file
+#define REPLAY_VERSION 2 // 2: seeds the game's random streams, not raylib's generator
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+typedef enum ReplayValue {
+    REPLAY_MOUSE_X,
+    REPLAY_MOUSE_Y,
+    REPLAY_MOUSE_DELTA_X,
+    REPLAY_MOUSE_DELTA_Y,
+    REPLAY_LEFT_STICK_X,
+    REPLAY_LEFT_STICK_Y,
+    REPLAY_RIGHT_STICK_X,
+    REPLAY_RIGHT_STICK_Y,
+    REPLAY_LEFT_TRIGGER,
+    REPLAY_RIGHT_TRIGGER,
+    REPLAY_FRAME_TIME,
+    REPLAY_VALUE_COUNT
+} ReplayValue;
+
+// Input for one tick
+typedef struct ReplayTick {
+    unsigned int buttons; // action and mouse bools, one bit each
+    float values[REPLAY_VALUE_COUNT];
+} ReplayTick;
+
+typedef struct ReplayState {
+    unsigned char *data; // encoded ticks, without the header
+    unsigned int size;
+    unsigned int capacity;
+    unsigned int readPosition;
+    unsigned int tickCount; // recorded, or left to play
+    unsigned int seed;
+    unsigned int runLength; // ticks left to repeat (playing), or not written yet (recording)
+    ReplayTick previous; // ticks are written as changes from the one before
+    const char *fileName; // where recordings are saved
+    bool isRecording;
+    bool isPlaying;
+    bool recordSessions;
+} ReplayState;
+
+// Prototypes
+// ----------------------------------------------------------------------------
+void EnableReplayRecording(const char *fileName); // Record every gameplay session, saved to fileName when it ends
+bool LoadReplay(const char *fileName); // Load a replay to play, returns false if it can't be read
+void FreeReplay(void);
+void StartReplaySession(void); // Call when gameplay starts, after seeding the game (a replay sets its own seed)
+void EndReplaySession(void); // Call when gameplay ends, saves the recording
+void RecordReplayTick(void); // Store the input a tick is about to use
+bool PlayReplayTick(void); // Set the input (and frame time) for the next tick, returns false when the replay is over
+bool IsReplayPlaying(void);
+unsigned int GetReplayTickCount(void); // Ticks recorded so far, or left to play
+
+#endif // ASTEROIDS_REPLAY_HEADER_GUARD
@@ -5,7 +5,6 @@
 #define ASTEROIDS_SHIP_HEADER_GUARD
 
 #include "raylib.h"
-#include "missile.h"
 
 // Macros
 // ----------------------------------------------------------------------------
@@ -23,37 +22,50 @@
 // Types and Structures
 // ----------------------------------------------------------------------------
 
+// What UpdateShip() reads and writes every tick, fits in one cache line
+// (see the asserts in game.h)
 typedef struct SpaceShip {
-    Texture sprite;
-    Sound soundExplode;
-    Sound soundShoot;
-    Missile missiles[MISSILE_MAX];
     Vector2 position;
-    Vector2 shipPoints[3]; // used for collision
-    Vector2 jetPoints[3];
     Vector2 velocity;
     float angle; // in degrees, 0 is pointing up, 90 is right
-    float width;
-    float length;
     float autoFireTimer;
     float respawnTimer;
     float safeRespawnTimer;
     float explosionTimer;
-    unsigned int shotCount;
     bool isThrusting;
-    bool isAtScreenEdge;
     bool isExploded;
 } SpaceShip;
 
+// Where the hull is this tick, worked out once per tick for collision
+// Collision sweeps it from where it was at the start of the tick, so fast
+// ships can't pass through rocks between ticks
+typedef struct SpaceShipHull {
+    Vector2 center; // the ship's position
+    Vector2 points[3];
+    Vector2 previousCenter; // at the start of the tick
+    Vector2 previousPoints[3];
+    Rectangle bounds; // around the points and previous points
+    float radius; // around the center, the same at any angle
+} SpaceShipHull;
+
+// Only used for drawing
+typedef struct SpaceShipDrawState {
+    Vector2 previousPosition; // at the previous tick, for drawing between ticks
+    float previousAngle;
+    Vector2 jetPoints[3]; // where the jet is drawn
+} SpaceShipDrawState;
+
 
 // Prototypes
 // ----------------------------------------------------------------------------
 
 void UpdateShip(SpaceShip *ship); // Take player input and update ship
-void DrawShip(SpaceShip *ship);
+void DrawShip(const SpaceShip *ship, SpaceShipDrawState *draw); // Queue the ship and its clones (see render.h)
 
-void UpdateShipTriangles(SpaceShip *ship); // Calculate ship's hitbox for collision
+void UpdateShipHull(SpaceShipHull *hull, const SpaceShip *previous, const SpaceShip *ship); // Calculate the ship's hitbox for collision, swept from previous to ship
+void UpdateShipJetTriangle(SpaceShipDrawState *draw, Vector2 position, float angle); // Calculate the jet triangle to draw
 void RotateShipToMouse(SpaceShip *ship);
+void ExplodeShip(SpaceShip *ship); // Lose a life, ship hits are applied at the end of the tick (see events.h)
 void RespawnShip(SpaceShip *ship);
 void ShootMissile(SpaceShip *ship);
 
@@ -17,6 +17,7 @@
 #define UI_FONT_SIZE_EDGE    75    // top of screen font size
 #define UI_BUTTON_THICKNESS  20    // area around text to click
 #define UI_TRANSPARENCY      0.10f // only used for touch input buttons
+#define UI_TEXT_LENGTH       32    // longest cached text, see UpdateUiText()
 
 
 // UI spacing
@@ -31,6 +32,9 @@
 #define UI_INPUT_ON_PRESS 0
 #define UI_INPUT_ON_HOLD 1
 
+// Debug
+#define UI_PROFILER_GRAPH_FRAMES 240 // frames shown in the frame time graph
+
 // Types and Structures
 // ----------------------------------------------------------------------------
 
@@ -48,6 +52,7 @@ typedef enum UiPauseMenuId {
 
 typedef struct UiButton {
     const char *text;
+    Rectangle bounds; // text and the clickable area around it, measured once
     Texture icon;
     float iconScale;
     float radius;
@@ -73,6 +78,24 @@ typedef struct UiMenu {
     unsigned int buttonCount;
 } UiMenu;
 
+// Text that's only formatted and measured again when what it shows changes
+typedef struct UiText {
+    const char *format; // text was made from format and value
+    int value;
+    int fontSize;
+    int width;
+    char text[UI_TEXT_LENGTH];
+} UiText;
+
+// Gameplay text, kept between frames
+typedef struct UiHud {
+    UiText lives;
+    UiText level;
+    UiText remaining;
+    UiText center; // game over, level start, lives left, etc
+    UiText paused;
+} UiHud;
+
 // Virtual touchscreen input buttons
 typedef struct UiGamepad {
     UiButton pause;
@@ -83,6 +106,7 @@ typedef struct UiGamepad {
 
 typedef struct UiState {
     UiGamepad gamepad;
+    UiHud hud;
     UiButton title[2]; // Title text
     // UiButton *buttons; // non-menu buttons
     UiMenu menus[3]; // title, difficulty, and pause menus
@@ -110,6 +134,7 @@ UiButton InitUiInputButton(char *text, int inputActionId, float textPosX, float
 UiButton *CreateUiMenuButton(char *text, UiMenu *menu, float textPosX, float textPosY, int fontSize); // Initializes a button within a menu
 UiButton *CreateUiMenuButtonRelative(char* text, UiMenu *menu, float offsetY, int fontSize); // Initializes a button within a menu relative to the last menu button
 void FreeUiState(void); // Frees memory for all menu buttons
+void UpdateUiText(UiText *text, const char *format, int value, int fontSize); // Format and measure text, only when format, value or size changed
 
 // Update / User Input
 void UpdateUiFrame(void); // Updates the menu for the current frame
@@ -133,5 +158,6 @@ void DrawLives(void);
 void DrawCenterText(void); // Draws center text based on game state
                            // TODO replace with something like SetCenterText(char *text, float time)?
 void DrawDebugInfo(void);
+void DrawProfilerInfo(void); // Draw the frame time graph and last frame's zone times
 
 #endif // ASTEROIDS_MENU_HEADER_GUARD
@@ -8,7 +8,36 @@
 #include "game.h"
 
 InputActionMaps inputMaps;
+InputActionTable inputTable; // compiled from inputMaps
 
+#define INPUT_ACTION_BIT(action) (1u << (action))
+
+// Local Functions
+// ----------------------------------------------------------------------------
+
+// Add actions to a key or button's entry, returns its index (or -1 if the table is full)
+static int AddInputBinding(InputBinding *bindings, unsigned int *count, int code, InputActionMask actions)
+{
+    for (unsigned int i = 0; i < *count; i++)
+    {
+        if (bindings[i].code == code)
+        {
+            bindings[i].actions |= actions;
+            return (int)i;
+        }
+    }
+
+    if (*count == INPUT_MAX_DEVICE_INPUTS)
+    {
+        TraceLog(LOG_WARNING, "INPUT: Too many mapped inputs, %i is ignored", code);
+        return -1;
+    }
+    bindings[*count] = (InputBinding){ code, actions };
+    return (int)(*count)++;
+}
+
+// Primary
+// ----------------------------------------------------------------------------
 void InitDefaultInputSettings(void)
 {
     // Setup input defaults
@@ -38,6 +67,7 @@ void InitDefaultInputSettings(void)
             KEY_F11,
         },
         .key[INPUT_ACTION_DEBUG] = { KEY_F3 },
+        .key[INPUT_ACTION_TRACE] = { KEY_F4 },
 
         // Menu controls
         .gamepadButton[INPUT_ACTION_CONFIRM] =   { GAMEPAD_BUTTON_SOUTH },
@@ -67,10 +97,120 @@ void InitDefaultInputSettings(void)
         .mouse[INPUT_ACTION_THRUST] = { MOUSE_RIGHT_BUTTON },
         .mouse[INPUT_ACTION_SHOOT] =  { INPUT_MOUSE_LEFT_BUTTON },
     };
+
+    CompileInputActionMaps();
+}
+
+void CompileInputActionMaps(void)
+{
+    InputActionTable table = { 0 };
+
+    for (unsigned int action = 0; action < INPUT_MAX_ACTIONS; action++)
+    {
+        InputActionMask actionBit = INPUT_ACTION_BIT(action);
+
+        // Keys, a modifier followed by a key is a combo (only 1 modifier for now)
+        KeyboardKey *keys = inputMaps.key[action];
+        for (unsigned int i = 0; i < INPUT_MAX_MAPS && keys[i] != 0; i++)
+        {
+            if (IsInputKeyModifier(keys[i]) && (i + 1 < INPUT_MAX_MAPS) &&
+                (keys[i + 1] != 0) && !IsInputKeyModifier(keys[i + 1]))
+            {
+                int modifierIdx = AddInputBinding(table.keys, &table.keyCount, keys[i], 0);
+                int keyIdx = AddInputBinding(table.keys, &table.keyCount, keys[i + 1], 0);
+                i++; // skip the key
+                if ((modifierIdx < 0) || (keyIdx < 0))
+                    continue;
+                if (table.keyComboCount == INPUT_MAX_KEY_COMBOS)
+                {
+                    TraceLog(LOG_WARNING, "INPUT: Too many key combos, %i+%i is ignored", keys[i - 1], keys[i]);
+                    continue;
+                }
+                table.keyCombos[table.keyComboCount++] = (InputKeyCombo){ (unsigned int)modifierIdx, (unsigned int)keyIdx, actionBit };
+            }
+            else AddInputBinding(table.keys, &table.keyCount, keys[i], actionBit);
+        }
+
+        // Gamepad buttons and axes
+        GamepadButton *buttons = inputMaps.gamepadButton[action];
+        for (unsigned int i = 0; i < INPUT_MAX_MAPS && buttons[i] != 0; i++)
+            AddInputBinding(table.gamepadButtons, &table.gamepadButtonCount, buttons[i], actionBit);
+        if (inputMaps.gamepadAxis[action].axis != 0)
+            table.axisActions |= actionBit;
+
+        // Mouse buttons
+        MouseButton *mouseButtons = inputMaps.mouse[action];
+        for (unsigned int i = 0; i < 4 && mouseButtons[i] != 0; i++)
+        {
+            MouseButton button = mouseButtons[i];
+            if (button == INPUT_MOUSE_LEFT_BUTTON)
+                button = MOUSE_LEFT_BUTTON;
+            AddInputBinding(table.mouseButtons, &table.mouseButtonCount, button, actionBit);
+        }
+    }
+
+    inputTable = table;
+}
+
+void SampleInputActions(void)
+{
+    InputActionMask down = input.touchActionsDown;
+    InputActionMask pressed = input.touchActionsPressed;
+
+    // Keys, each checked once for every action and combo using it
+    bool keyDown[INPUT_MAX_DEVICE_INPUTS];
+    bool keyPressed[INPUT_MAX_DEVICE_INPUTS];
+    for (unsigned int i = 0; i < inputTable.keyCount; i++)
+    {
+        InputBinding *binding = &inputTable.keys[i];
+        keyDown[i] = IsKeyDown(binding->code);
+        keyPressed[i] = IsKeyPressed(binding->code);
+        if (keyDown[i]) down |= binding->actions;
+        if (keyPressed[i]) pressed |= binding->actions;
+    }
+    for (unsigned int i = 0; i < inputTable.keyComboCount; i++)
+    {
+        InputKeyCombo *combo = &inputTable.keyCombos[i];
+        if (!keyDown[combo->modifierIdx])
+            continue;
+        if (keyDown[combo->keyIdx]) down |= combo->actions;
+        if (keyPressed[combo->keyIdx]) pressed |= combo->actions;
+    }
+
+    // Gamepad
+    if (input.gamepad.available)
+    {
+        for (unsigned int i = 0; i < inputTable.gamepadButtonCount; i++)
+        {
+            InputBinding *binding = &inputTable.gamepadButtons[i];
+            if (IsGamepadButtonDown(input.gamepadId, binding->code)) down |= binding->actions;
+            if (IsGamepadButtonPressed(input.gamepadId, binding->code)) pressed |= binding->actions;
+        }
+        down |= input.axisActionsCurrentFrame;
+        pressed |= input.axisActionsCurrentFrame & ~input.axisActionsPreviousFrame;
+    }
+
+    // Mouse
+    input.mouseActionsDown = 0;
+    input.mouseActionsPressed = 0;
+    for (unsigned int i = 0; i < inputTable.mouseButtonCount; i++)
+    {
+        InputBinding *binding = &inputTable.mouseButtons[i];
+        if (IsMouseButtonDown(binding->code)) input.mouseActionsDown |= binding->actions;
+        if (IsMouseButtonPressed(binding->code)) input.mouseActionsPressed |= binding->actions;
+    }
+
+    input.actionsDown = down | input.mouseActionsDown;
+    input.actionsPressed = pressed | input.mouseActionsPressed;
 }
 
 void ProcessUserInput(void)
 {
+    // Gameplay can have frames without a tick, presses on those wait for the next one
+    InputState held = { 0 };
+    if (input.holdPressed)
+        held = input;
+
     KeyboardKey currentKey = GetKeyPressed();
     if (IsInputKeyModifier(currentKey))
         input.anyKeyPressed = false;
@@ -100,12 +240,12 @@ void ProcessUserInput(void)
         input.gamepad.leftTrigger = GetGamepadAxisMovement(input.gamepadId, GAMEPAD_AXIS_LEFT_TRIGGER);
         input.gamepad.rightTrigger = GetGamepadAxisMovement(input.gamepadId, GAMEPAD_AXIS_RIGHT_TRIGGER);
 
+        input.axisActionsPreviousFrame = input.axisActionsCurrentFrame;
+        input.axisActionsCurrentFrame = 0;
         for (int i = 0; i < INPUT_MAX_ACTIONS; i++)
         {
-            if (inputMaps.gamepadAxis[i].axis == 0)
-                continue;
-            input.gamepadAxisPressedPreviousFrame[i] = input.gamepadAxisPressedCurrentFrame[i];
-            input.gamepadAxisPressedCurrentFrame[i] = IsInputActionAxisDown(i);
+            if ((inputTable.axisActions & INPUT_ACTION_BIT(i)) && IsInputActionAxisDown(i))
+                input.axisActionsCurrentFrame |= INPUT_ACTION_BIT(i);
         }
     }
     else input.anyGamepadButtonPressed = false;
@@ -149,8 +289,10 @@ void ProcessUserInput(void)
     }
 
     // Check input mappings
+    SampleInputActions();
     input.global.fullscreen =  IsInputActionPressed(INPUT_ACTION_FULLSCREEN);
     input.global.debug =       IsInputActionPressed(INPUT_ACTION_DEBUG);
+    input.global.saveTrace =   IsInputActionPressed(INPUT_ACTION_TRACE);
     if (ui.currentMenu != UI_MENU_NONE)
     {
         input.menu.confirm =     IsInputActionPressed(INPUT_ACTION_CONFIRM);
@@ -168,6 +310,21 @@ void ProcessUserInput(void)
         input.player.thrustMouse = IsInputActionMouseDown(INPUT_ACTION_THRUST);
         input.player.shootMouse =  IsInputActionMouseDown(INPUT_ACTION_SHOOT);
     }
+
+    if (input.holdPressed)
+    {
+        input.global.debug |= held.global.debug;
+        input.menu.confirm |= held.menu.confirm;
+        input.menu.cancel |= held.menu.cancel;
+        input.player.pause |= held.player.pause;
+        input.mouse.tapped |= held.mouse.tapped;
+        input.mouse.leftPressed |= held.mouse.leftPressed;
+        input.mouse.rightPressed |= held.mouse.rightPressed;
+        input.anyKeyPressed |= held.anyKeyPressed;
+        input.anyGamepadButtonPressed |= held.anyGamepadButtonPressed;
+        input.anyInputPressed |= held.anyInputPressed;
+    }
+    input.holdPressed = (game.currentScreen == SCREEN_GAMEPLAY); // until ConsumeUserInput()
 }
 
 void CancelUserInput(void)
@@ -180,6 +337,21 @@ void CancelUserInput(void)
     input.anyInputPressed = false;
 }
 
+void ConsumeUserInput(void)
+{
+    input.global.debug = false;
+    input.menu.confirm = false;
+    input.menu.cancel = false;
+    input.player.pause = false;
+    input.mouse.tapped = false;
+    input.mouse.leftPressed = false;
+    input.mouse.rightPressed = false;
+    input.anyKeyPressed = false;
+    input.anyGamepadButtonPressed = false;
+    input.anyInputPressed = false;
+    input.holdPressed = false;
+}
+
 // Input Actions
 // ----------------------------------------------------------------------------
 bool IsInputKeyModifier(KeyboardKey key)
@@ -193,54 +365,7 @@ bool IsInputKeyModifier(KeyboardKey key)
 
 bool IsInputActionDown(InputAction action)
 {
-    // Check touch screen button
-    if (input.touchButtonDown[action] == true)
-        return true;
-
-    // Check controller buttons
-    if (input.gamepad.available)
-    {
-        GamepadButton *buttons = inputMaps.gamepadButton[action];
-        for (unsigned int i = 0; i < INPUT_MAX_MAPS && buttons[i] != 0; i++)
-        {
-            GamepadButton button = buttons[i];
-            if (IsGamepadButtonDown(input.gamepadId, button))
-                return true;
-        }
-        if (IsInputActionAxisDown(action))
-            return true;
-    }
-
-    // Check potential key combinations
-    KeyboardKey* keys = inputMaps.key[action];
-    for (unsigned int i = 0; i < INPUT_MAX_MAPS && keys[i] != 0; i++)
-    {
-        KeyboardKey key = keys[i];
-
-        // Check modifier plus next key (only 1 modifier for now)
-        if (IsInputKeyModifier(key))
-        {
-            if ((i + 1 < INPUT_MAX_MAPS) && (keys[i + 1] != 0) &&
-                (!IsInputKeyModifier(keys[i + 1])))
-            {
-                if (IsKeyDown(key) && IsKeyDown(keys[i + 1]))
-                    return true;
-                i++;
-            }
-            // Check just the modifier by itself
-            else if (IsKeyDown(key))
-                return true;
-        }
-
-        else if (IsKeyDown(key))
-            return true;
-    }
-
-    // Check mouse buttons
-    if (IsInputActionMouseDown(action))
-        return true;
-
-    return false;
+    return (input.actionsDown & INPUT_ACTION_BIT(action)) != 0;
 }
 
 bool IsInputActionAxisDown(InputAction action)
@@ -277,106 +402,39 @@ bool IsInputActionAxisDown(InputAction action)
 
 bool IsInputActionMouseDown(InputAction action)
 {
-    MouseButton* mb = inputMaps.mouse[action];
-    for (unsigned int i = 0; i < INPUT_MAX_MAPS && mb[i] != 0; i++)
-    {
-        MouseButton button = mb[i];
-        if (button == INPUT_MOUSE_LEFT_BUTTON)
-            button = MOUSE_LEFT_BUTTON;
-        if (IsMouseButtonDown(button))
-            return true;
-    }
-
-    return false;
+    return (input.mouseActionsDown & INPUT_ACTION_BIT(action)) != 0;
 }
 
 bool IsInputActionPressed(InputAction action)
 {
-    // Check touch screen button
-    if (input.touchButtonPressed[action] == true)
-        return true;
-
-    // Check controller input
-    if (input.gamepad.available)
-    {
-        // buttons
-        GamepadButton *buttons = inputMaps.gamepadButton[action];
-        for (unsigned int i = 0; i < INPUT_MAX_MAPS && buttons[i] != 0; i++)
-        {
-            GamepadButton button = buttons[i];
-            if (IsGamepadButtonPressed(input.gamepadId, button))
-                return true;
-        }
-        if (IsInputActionAxisPressed(action))
-            return true;
-    }
-
-    // Check potential key combinations
-    KeyboardKey* keys = inputMaps.key[action];
-    for (unsigned int i = 0; i < INPUT_MAX_MAPS && keys[i] != 0; i++)
-    {
-        KeyboardKey key = keys[i];
-
-        // Check modifier plus next key (only 1 modifier for now)
-        if (IsInputKeyModifier(key))
-        {
-            if ((i + 1 < INPUT_MAX_MAPS) && (keys[i + 1] != 0) &&
-                (!IsInputKeyModifier(keys[i + 1])))
-            {
-                if (IsKeyDown(key) && IsKeyPressed(keys[i + 1]))
-                    return true;
-                i++; // Skip the next key
-            }
-            // Check just the modifier by itself
-            else if (IsKeyPressed(key))
-                return true;
-        }
-
-        // Check a single key
-        else if (IsKeyPressed(key))
-            return true;
-    }
-
-    // Check mouse buttons
-    if (IsInputActionMousePressed(action))
-        return true;
-
-    return false;
+    return (input.actionsPressed & INPUT_ACTION_BIT(action)) != 0;
 }
 
 bool IsInputActionAxisPressed(InputAction action)
 {
-    if (!input.gamepadAxisPressedPreviousFrame[action] &&
-        input.gamepadAxisPressedCurrentFrame[action])
-        return true;
-
-    return false;
+    InputActionMask newlyDown = input.axisActionsCurrentFrame & ~input.axisActionsPreviousFrame;
+    return (newlyDown & INPUT_ACTION_BIT(action)) != 0;
 }
 
 bool IsInputActionMousePressed(InputAction action)
 {
-    MouseButton* mb = inputMaps.mouse[action];
-    for (unsigned int i = 0; i < INPUT_MAX_MAPS && mb[i] != 0; i++)
-    {
-        MouseButton button = mb[i];
-        if (button == INPUT_MOUSE_LEFT_BUTTON)
-            button = MOUSE_LEFT_BUTTON;
-        if (IsMouseButtonPressed(button))
-            return true;
-    }
-
-    return false;
+    return (input.mouseActionsPressed & INPUT_ACTION_BIT(action)) != 0;
 }
 
 // Touch / Virtual Input
 // ----------------------------------------------------------------------------
 void SetTouchInputAction(InputAction action, bool isButtonDown)
 {
-    if (isButtonDown && !input.touchButtonDown[action])
-        input.touchButtonPressed[action] = true;
+    InputActionMask actionBit = INPUT_ACTION_BIT(action);
+    if (isButtonDown && !(input.touchActionsDown & actionBit))
+        input.touchActionsPressed |= actionBit;
+    else
+        input.touchActionsPressed &= ~actionBit;
+
+    if (isButtonDown)
+        input.touchActionsDown |= actionBit;
     else
-        input.touchButtonPressed[action] = false;
-    input.touchButtonDown[action] = isButtonDown;
+        input.touchActionsDown &= ~actionBit;
 }
 
 void SetTouchPointButton(int index, int buttonIdx)
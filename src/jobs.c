@@ -0,0 +1,413 @@
+// EXPLANATION:
+// A small work-stealing thread pool
+// See jobs.h for more documentation/descriptions
+
+#if !defined(_WIN32) && !defined(__APPLE__) && !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE 200112L // for pthreads and sysconf with -std=c99
+#endif
+
+#include "jobs.h"
+
+#include "atomics.h"
+#include "profiler.h"
+
+#if defined(PLATFORM_WEB)
+    // No threads, browsers need extra setup for them (SharedArrayBuffer)
+    typedef int JobMutex;
+    typedef int JobCondition;
+    typedef int JobThread;
+#elif defined(_WIN32)
+    #include <process.h> // for _beginthreadex
+
+    // windows.h clashes with raylib.h, so only declare what's needed
+    typedef struct { void *ptr; } JobMutex; // SRWLOCK
+    typedef struct { void *ptr; } JobCondition; // CONDITION_VARIABLE
+    typedef void *JobThread; // HANDLE
+    __declspec(dllimport) void __stdcall InitializeSRWLock(JobMutex *lock);
+    __declspec(dllimport) void __stdcall AcquireSRWLockExclusive(JobMutex *lock);
+    __declspec(dllimport) void __stdcall ReleaseSRWLockExclusive(JobMutex *lock);
+    __declspec(dllimport) void __stdcall InitializeConditionVariable(JobCondition *condition);
+    __declspec(dllimport) int __stdcall SleepConditionVariableSRW(JobCondition *condition, JobMutex *lock, unsigned long milliseconds, unsigned long flags);
+    __declspec(dllimport) void __stdcall WakeAllConditionVariable(JobCondition *condition);
+    __declspec(dllimport) unsigned long __stdcall WaitForSingleObject(void *handle, unsigned long milliseconds);
+    __declspec(dllimport) int __stdcall CloseHandle(void *handle);
+    __declspec(dllimport) unsigned long __stdcall GetActiveProcessorCount(unsigned short groupNumber);
+#else
+    #include <pthread.h>
+    #include <unistd.h> // for sysconf
+    typedef pthread_mutex_t JobMutex;
+    typedef pthread_cond_t JobCondition;
+    typedef pthread_t JobThread;
+#endif
+
+// Types and Structures
+// ----------------------------------------------------------------------------
+
+// Chunks a thread has left, the owner takes from the front and thieves from the back
+typedef struct JobQueue {
+    unsigned int lock; // spinlock, held for a few instructions at a time
+    unsigned int first;
+    unsigned int last;
+    unsigned char padding[64 - 3*sizeof(unsigned int)]; // one queue per cache line
+} JobQueue;
+
+typedef struct JobSystem {
+    JobQueue queues[JOB_MAX_THREADS];
+    JobThread threads[JOB_MAX_WORKERS];
+    unsigned int workerCount;
+
+    // Background thread, separate from the pool
+    JobThread background;
+    BackgroundFunction backgroundFunction;
+    void *backgroundData;
+    bool isBackgroundRunning; // until WaitBackgroundThread() joins it
+
+    // Current loop, only read after taking a chunk from a queue
+    JobFunction function;
+    void *data;
+    unsigned int count;
+    unsigned int chunkSize;
+
+    unsigned int chunksLeft; // atomic
+    unsigned int generation; // bumped for every loop, wakes the workers
+    bool shouldExit;
+    JobMutex mutex; // guards generation and shouldExit, and the conditions
+    JobCondition wake;
+    JobCondition done;
+} JobSystem;
+
+// Globals
+// ----------------------------------------------------------------------------
+static JobSystem jobs = { 0 };
+static THREAD_LOCAL unsigned int jobThreadIndex = 0;
+
+// Platform
+// ----------------------------------------------------------------------------
+#if defined(PLATFORM_WEB)
+static void InitJobMutex(JobMutex *mutex) { (void)mutex; }
+static void FreeJobMutex(JobMutex *mutex) { (void)mutex; }
+static void LockJobMutex(JobMutex *mutex) { (void)mutex; }
+static void UnlockJobMutex(JobMutex *mutex) { (void)mutex; }
+static void InitJobCondition(JobCondition *condition) { (void)condition; }
+static void FreeJobCondition(JobCondition *condition) { (void)condition; }
+static void WaitJobCondition(JobCondition *condition, JobMutex *mutex) { (void)condition; (void)mutex; }
+static void WakeJobCondition(JobCondition *condition) { (void)condition; }
+#elif defined(_WIN32)
+static unsigned __stdcall RunJobWorker(void *arg);
+static unsigned __stdcall RunBackgroundWorker(void *arg);
+static void InitJobMutex(JobMutex *mutex) { InitializeSRWLock(mutex); }
+static void FreeJobMutex(JobMutex *mutex) { (void)mutex; }
+static void LockJobMutex(JobMutex *mutex) { AcquireSRWLockExclusive(mutex); }
+static void UnlockJobMutex(JobMutex *mutex) { ReleaseSRWLockExclusive(mutex); }
+static void InitJobCondition(JobCondition *condition) { InitializeConditionVariable(condition); }
+static void FreeJobCondition(JobCondition *condition) { (void)condition; }
+static void WaitJobCondition(JobCondition *condition, JobMutex *mutex) { SleepConditionVariableSRW(condition, mutex, 0xFFFFFFFF, 0); }
+static void WakeJobCondition(JobCondition *condition) { WakeAllConditionVariable(condition); }
+static bool StartJobThread(JobThread *thread, unsigned int threadIdx)
+{
+    *thread = (JobThread)_beginthreadex(NULL, 0, RunJobWorker, (void *)(size_t)threadIdx, 0, NULL);
+    return (*thread != NULL);
+}
+static bool StartBackgroundJobThread(JobThread *thread)
+{
+    *thread = (JobThread)_beginthreadex(NULL, 0, RunBackgroundWorker, NULL, 0, NULL);
+    return (*thread != NULL);
+}
+static void JoinJobThread(JobThread thread)
+{
+    WaitForSingleObject(thread, 0xFFFFFFFF);
+    CloseHandle(thread);
+}
+#else
+static void *RunJobWorker(void *arg);
+static void *RunBackgroundWorker(void *arg);
+static void InitJobMutex(JobMutex *mutex) { pthread_mutex_init(mutex, NULL); }
+static void FreeJobMutex(JobMutex *mutex) { pthread_mutex_destroy(mutex); }
+static void LockJobMutex(JobMutex *mutex) { pthread_mutex_lock(mutex); }
+static void UnlockJobMutex(JobMutex *mutex) { pthread_mutex_unlock(mutex); }
+static void InitJobCondition(JobCondition *condition) { pthread_cond_init(condition, NULL); }
+static void FreeJobCondition(JobCondition *condition) { pthread_cond_destroy(condition); }
+static void WaitJobCondition(JobCondition *condition, JobMutex *mutex) { pthread_cond_wait(condition, mutex); }
+static void WakeJobCondition(JobCondition *condition) { pthread_cond_broadcast(condition); }
+static bool StartJobThread(JobThread *thread, unsigned int threadIdx)
+{
+    return (pthread_create(thread, NULL, RunJobWorker, (void *)(size_t)threadIdx) == 0);
+}
+static bool StartBackgroundJobThread(JobThread *thread)
+{
+    return (pthread_create(thread, NULL, RunBackgroundWorker, NULL) == 0);
+}
+static void JoinJobThread(JobThread thread)
+{
+    pthread_join(thread, NULL);
+}
+#endif
+
+// Queues
+// ----------------------------------------------------------------------------
+static void LockJobQueue(JobQueue *queue)
+{
+    while (AtomicExchange(&queue->lock, 1) != 0)
+    {
+        while (AtomicLoad(&queue->lock) != 0)
+            CpuRelax();
+    }
+}
+
+static void UnlockJobQueue(JobQueue *queue)
+{
+    AtomicStore(&queue->lock, 0);
+}
+
+static void SetJobQueue(JobQueue *queue, unsigned int first, unsigned int last)
+{
+    LockJobQueue(queue);
+    queue->first = first;
+    queue->last = last;
+    UnlockJobQueue(queue);
+}
+
+// Take a chunk from the front of the thread's own queue, or steal one from the
+// back of another's, returns false when there are none left anywhere
+static bool TakeJobChunk(unsigned int threadIdx, unsigned int *chunkIdx)
+{
+    unsigned int threadCount = jobs.workerCount + 1;
+    for (unsigned int i = 0; i < threadCount; i++)
+    {
+        JobQueue *queue = &jobs.queues[(threadIdx + i) % threadCount];
+        bool found = false;
+        LockJobQueue(queue);
+        if (queue->first < queue->last)
+        {
+            *chunkIdx = (i == 0)? queue->first++ : --queue->last;
+            found = true;
+        }
+        UnlockJobQueue(queue);
+        if (found)
+            return true;
+    }
+
+    return false;
+}
+
+static void RunJobChunk(unsigned int chunkIdx)
+{
+    unsigned int first = chunkIdx*jobs.chunkSize;
+    unsigned int last = (jobs.count - first > jobs.chunkSize)? first + jobs.chunkSize : jobs.count;
+    jobs.function(jobs.data, first, last, chunkIdx);
+}
+
+// Run chunks until every queue is empty
+static void RunJobChunks(unsigned int threadIdx)
+{
+    unsigned int chunkIdx = 0;
+    while (TakeJobChunk(threadIdx, &chunkIdx))
+    {
+        PROFILE_BEGIN(PROFILE_JOB);
+        RunJobChunk(chunkIdx);
+        PROFILE_END(PROFILE_JOB);
+
+        // The last chunk to finish wakes the thread waiting in RunParallelFor()
+        if (AtomicFetchSub(&jobs.chunksLeft, 1) == 1)
+        {
+            LockJobMutex(&jobs.mutex);
+            WakeJobCondition(&jobs.done);
+            UnlockJobMutex(&jobs.mutex);
+        }
+    }
+}
+
+#if !defined(PLATFORM_WEB)
+#if defined(_WIN32)
+static unsigned __stdcall RunJobWorker(void *arg)
+#else
+static void *RunJobWorker(void *arg)
+#endif
+{
+    jobThreadIndex = (unsigned int)(size_t)arg;
+    unsigned int generation = 0;
+
+    LockJobMutex(&jobs.mutex);
+    while (true)
+    {
+        while ((jobs.generation == generation) && !jobs.shouldExit)
+            WaitJobCondition(&jobs.wake, &jobs.mutex);
+        if (jobs.shouldExit)
+            break;
+        generation = jobs.generation;
+
+        UnlockJobMutex(&jobs.mutex);
+        RunJobChunks(jobThreadIndex);
+        LockJobMutex(&jobs.mutex);
+    }
+    UnlockJobMutex(&jobs.mutex);
+
+    return 0;
+}
+
+#if defined(_WIN32)
+static unsigned __stdcall RunBackgroundWorker(void *arg)
+#else
+static void *RunBackgroundWorker(void *arg)
+#endif
+{
+    (void)arg;
+    jobs.backgroundFunction(jobs.backgroundData);
+    return 0;
+}
+#endif
+
+// Job System
+// ----------------------------------------------------------------------------
+void InitJobSystem(unsigned int workerCount)
+{
+#if defined(PLATFORM_WEB)
+    workerCount = 0;
+#endif
+    if (workerCount > JOB_MAX_WORKERS)
+        workerCount = JOB_MAX_WORKERS;
+
+    InitJobMutex(&jobs.mutex);
+    InitJobCondition(&jobs.wake);
+    InitJobCondition(&jobs.done);
+    jobs.shouldExit = false;
+    jobs.workerCount = 0;
+
+#if !defined(PLATFORM_WEB)
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        if (!StartJobThread(&jobs.threads[i], i + 1))
+        {
+            TraceLog(LOG_WARNING, "JOBS: Failed to start worker thread %u", i + 1);
+            break;
+        }
+        jobs.workerCount++;
+    }
+#endif
+
+    TraceLog(LOG_INFO, "JOBS: Started %u worker threads", jobs.workerCount);
+}
+
+void FreeJobSystem(void)
+{
+    WaitBackgroundThread();
+
+    LockJobMutex(&jobs.mutex);
+    jobs.shouldExit = true;
+    WakeJobCondition(&jobs.wake);
+    UnlockJobMutex(&jobs.mutex);
+
+#if !defined(PLATFORM_WEB)
+    for (unsigned int i = 0; i < jobs.workerCount; i++)
+        JoinJobThread(jobs.threads[i]);
+#endif
+    jobs.workerCount = 0;
+
+    FreeJobCondition(&jobs.done);
+    FreeJobCondition(&jobs.wake);
+    FreeJobMutex(&jobs.mutex);
+}
+
+unsigned int GetJobWorkerCount(void)
+{
+    return jobs.workerCount;
+}
+
+unsigned int GetJobThreadIndex(void)
+{
+    return jobThreadIndex;
+}
+
+unsigned int GetProcessorCount(void)
+{
+#if defined(PLATFORM_WEB)
+    return 1;
+#elif defined(_WIN32)
+    unsigned long count = GetActiveProcessorCount(0xFFFF); // all processor groups
+    return (count > 0)? (unsigned int)count : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0)? (unsigned int)count : 1;
+#endif
+}
+
+unsigned int GetJobChunkCount(unsigned int count, unsigned int chunkSize)
+{
+    return (count + chunkSize - 1)/chunkSize;
+}
+
+void RunParallelFor(unsigned int count, unsigned int chunkSize, JobFunction function, void *data)
+{
+    unsigned int chunkCount = GetJobChunkCount(count, chunkSize);
+    if (chunkCount == 0)
+        return;
+
+    jobs.function = function;
+    jobs.data = data;
+    jobs.count = count;
+    jobs.chunkSize = chunkSize;
+
+    // Not worth waking anyone
+    if ((jobs.workerCount == 0) || (chunkCount == 1))
+    {
+        for (unsigned int i = 0; i < chunkCount; i++)
+            RunJobChunk(i);
+        return;
+    }
+
+    // Share the chunks out evenly, in order, so a thread's chunks are next to each other
+    // Everything above is published by the queue locks before any chunk can be taken
+    unsigned int threadCount = jobs.workerCount + 1;
+    AtomicStore(&jobs.chunksLeft, chunkCount);
+    for (unsigned int i = 0; i < threadCount; i++)
+        SetJobQueue(&jobs.queues[i], chunkCount*i/threadCount, chunkCount*(i + 1)/threadCount);
+
+    LockJobMutex(&jobs.mutex);
+    jobs.generation++;
+    WakeJobCondition(&jobs.wake);
+    UnlockJobMutex(&jobs.mutex);
+
+    RunJobChunks(0);
+
+    LockJobMutex(&jobs.mutex);
+    while (AtomicLoad(&jobs.chunksLeft) > 0)
+        WaitJobCondition(&jobs.done, &jobs.mutex);
+    UnlockJobMutex(&jobs.mutex);
+}
+
+// Background Thread
+// ----------------------------------------------------------------------------
+bool StartBackgroundThread(BackgroundFunction function, void *data)
+{
+#if defined(PLATFORM_WEB)
+    (void)function;
+    (void)data;
+    return false;
+#else
+    if (jobs.isBackgroundRunning)
+        return false;
+
+    // Set before the thread starts, so it sees them
+    jobs.backgroundFunction = function;
+    jobs.backgroundData = data;
+    if (!StartBackgroundJobThread(&jobs.background))
+    {
+        TraceLog(LOG_WARNING, "JOBS: Failed to start background thread");
+        return false;
+    }
+    jobs.isBackgroundRunning = true;
+
+    return true;
+#endif
+}
+
+void WaitBackgroundThread(void)
+{
+#if !defined(PLATFORM_WEB)
+    if (!jobs.isBackgroundRunning)
+        return;
+
+    JoinJobThread(jobs.background);
+    jobs.isBackgroundRunning = false;
+#endif
+}
@@ -5,6 +5,8 @@
 #include "logo.h"
 #include "config.h"
 #include "game.h"
+#include "drawstats.h"
+#include "assets.h"
 
 // Global animation state
 LogoAnimation logo = { 0 };
@@ -132,6 +134,8 @@ void UpdateRaylibLogo(void)
             break;
 
         case LOGO_END: // Animation is finished
+            if (!IsAssetLoadingDone())
+                break; // if it was skipped, wait on a blank screen while the rest upload
             game.currentScreen++;
             break;
     }
@@ -4,11 +4,20 @@
 
 #include "raylib.h"
 
+#include <string.h> // for strcmp, to read the command line
+#include <time.h>   // for time, to seed each run differently
+
 #include "config.h" // Program config, e.g. window title/size, fps, vsync
 #include "input.h" // Input controls / key mappings
 #include "logo.h"  // Raylib logo animation
 #include "ui.h"    // User interface (menus and buttons)
 #include "game.h"
+#include "profiler.h" // Timing of the game loop's stages
+#include "jobs.h"     // Worker threads for updating many entities
+#include "render.h"   // Sorted, batched drawing of the game world
+#include "drawstats.h" // Draw call and batch flush counts
+#include "replay.h"    // Recording of gameplay input
+#include "assets.h"    // Background loading of textures and sounds
 
 #if defined(PLATFORM_WEB) // for compiling to wasm (web assembly)
     #include <emscripten/emscripten.h>
@@ -21,6 +30,8 @@ typedef struct Viewport {
 // Globals
 // ----------------------------------------------------------------------------
 GameState  game;  // program and game-specific data
+GameAssets assets; // sounds and textures
+GameWorld  world;  // arrays of game objects (rocks), see GameState
 InputState input; // input module (default mappings and helper functions)
 UiState    ui;    // user interface module
 Viewport   view;  // for rendering within aspect ratio
@@ -32,22 +43,29 @@ void RunGameLoop(void);     // Runs the game loop depending on platform
 
 void UpdateDrawFrame(void); // Update and Draw the current frame
                             // Most of the game loop's code is found in here
+void UpdateGameTicks(void); // Run as many fixed gameplay ticks as real time has passed
 
 void UpdateCameraViewport(void);
 void HandleToggleFullscreen(void);
 
 // Main entry point
 // ----------------------------------------------------------------------------
-int main(void)
+int main(int argc, char **argv)
 {
     // Initialization
     // ----------------------------------------------------------------------------
     CreateNewWindow();
     InitAudioDevice();
+    InitJobSystem(GetProcessorCount() - 1); // this thread works on jobs too
+    InitRenderQueue();
     InitDefaultInputSettings();
     InitRaylibLogo();
     InitUiState();
+    SetGameSeed((unsigned int)time(NULL));
     InitGameState(SCREEN_LOGO);
+    StartAssetLoading(); // decodes on a worker thread while the logo plays
+    if ((argc > 1) && !strcmp(argv[1], "--record")) // only when asked, it writes a file every session
+        EnableReplayRecording((argc > 2)? argv[2] : REPLAY_FILE);
 
     // No exit key (use alt+F4 or in-game exit option)
     SetExitKey(KEY_NULL);
@@ -61,8 +79,13 @@ int main(void)
 
     // De-Initialization
     // ----------------------------------------------------------------------------
+    EndReplaySession(); // if quitting during gameplay
+    FreeReplay();
+    FinishAssetLoading(); // if quitting during the logo, so nothing loads into freed assets
     FreeGameState();
     FreeUiState();
+    FreeJobSystem();
+    FreeRenderQueue();
     CloseAudioDevice();
     CloseWindow(); // Close window and OpenGL context
 
@@ -103,11 +126,20 @@ void UpdateDrawFrame(void)
     // Update
     // ----------------------------------------------------------------------------
 
+    PROFILE_BEGIN(PROFILE_FRAME);
+
     // Global updates
     game.frameTime = GetFrameTime();
+    PROFILE_BEGIN(PROFILE_INPUT);
     ProcessUserInput();
+    PROFILE_END(PROFILE_INPUT);
     HandleToggleFullscreen();
     UpdateCameraViewport();
+    UpdateAssetLoading(); // a few uploads a frame until everything is loaded
+
+    // Save the recent frames for chrome://tracing
+    if (input.global.saveTrace)
+        SaveProfilerTrace(PROFILER_TRACE_FILE);
 
     switch(game.currentScreen)
     {
@@ -115,14 +147,17 @@ void UpdateDrawFrame(void)
                               break;
         case SCREEN_TITLE:    UpdateUiFrame();
                               break;
-        case SCREEN_GAMEPLAY: UpdateGameFrame();
+        case SCREEN_GAMEPLAY: UpdateGameTicks();
                               break;
         default: break;
     }
 
     // Draw
     // ----------------------------------------------------------------------------
+    UpdateStarfield(view.width, view.height); // draws to a texture, so not between BeginDrawing() and EndDrawing()
+
     BeginDrawing();
+    BeginDrawStatsFrame();
     ClearBackground(BLACK);
 
         BeginScissorMode(view.x, view.y, // Draw within aspect ratio
@@ -133,9 +168,13 @@ void UpdateDrawFrame(void)
             {
                 case SCREEN_LOGO:     DrawRaylibLogo();
                                       break;
-                case SCREEN_TITLE:    DrawUiFrame();
+                case SCREEN_TITLE:    PROFILE_BEGIN(PROFILE_DRAW_UI);
+                                      DrawUiFrame();
+                                      PROFILE_END(PROFILE_DRAW_UI);
                                       break;
-                case SCREEN_GAMEPLAY: DrawGameFrame();
+                case SCREEN_GAMEPLAY: PROFILE_BEGIN(PROFILE_DRAW_GAME);
+                                      DrawGameFrame();
+                                      PROFILE_END(PROFILE_DRAW_GAME);
                                       break;
                 default: break;
             }
@@ -146,7 +185,38 @@ void UpdateDrawFrame(void)
     // Debug:
     // DrawFPS(0, 0);
 
+    PROFILE_BEGIN(PROFILE_END_DRAWING);
     EndDrawing();
+    EndDrawStatsFrame(game.currentScreen);
+    PROFILE_END(PROFILE_END_DRAWING);
+
+    PROFILE_END(PROFILE_FRAME);
+}
+
+void UpdateGameTicks(void)
+{
+    float frameTime = game.frameTime;
+
+    // After a long frame (e.g. window dragged), drop what's too far behind
+    game.tickAccumulator += frameTime;
+    if (game.tickAccumulator > TICK_MAX_CATCHUP*TICK_TIME)
+        game.tickAccumulator = TICK_MAX_CATCHUP*TICK_TIME;
+
+    game.frameTime = TICK_TIME;
+    while ((game.tickAccumulator >= TICK_TIME) &&
+           (game.currentScreen == SCREEN_GAMEPLAY)) // stop if a tick left gameplay
+    {
+        RecordReplayTick();
+        PROFILE_BEGIN(PROFILE_UPDATE_GAME);
+        UpdateGameFrame();
+        PROFILE_END(PROFILE_UPDATE_GAME);
+        ConsumeUserInput();
+        game.tickAccumulator -= TICK_TIME;
+    }
+    game.frameTime = frameTime;
+
+    // Leftover time decides how far to draw towards the current tick
+    game.tickBlend = game.tickAccumulator/TICK_TIME;
 }
 
 void UpdateCameraViewport(void)
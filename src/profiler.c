@@ -0,0 +1,213 @@
+// EXPLANATION:
+// Lightweight timing of the game loop's stages ("zones")
+// See profiler.h for more documentation/descriptions
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE 199309L // for clock_gettime with -std=c99
+#endif
+
+#include "profiler.h"
+
+#include <stdio.h> // for writing the trace file
+
+#include "atomics.h"
+#include "jobs.h" // for the thread of each event
+
+#if defined(_WIN32)
+    // windows.h clashes with raylib.h, so only declare what's needed
+    __declspec(dllimport) int __stdcall QueryPerformanceCounter(long long *count);
+    __declspec(dllimport) int __stdcall QueryPerformanceFrequency(long long *frequency);
+#else
+    #include <time.h> // for clock_gettime
+#endif
+
+// Ring buffer of events, writers claim a slot by bumping the write index
+static ProfileEvent profileEvents[PROFILER_EVENT_CAPACITY];
+static unsigned int profileWriteIndex = 0;
+
+// Readers work on a copy, so writers are never blocked
+static ProfileEvent profileSnapshot[PROFILER_EVENT_CAPACITY];
+static unsigned int profileSnapshotCount = 0;
+
+static const char *profileZoneNames[PROFILE_ZONE_COUNT] = {
+    [PROFILE_FRAME]        = "Frame",
+    [PROFILE_INPUT]        = "ProcessUserInput",
+    [PROFILE_UPDATE_GAME]  = "UpdateGameFrame",
+    [PROFILE_UPDATE_ROCKS] = "UpdateAsteroids",
+    [PROFILE_UPDATE_SHIP]  = "UpdateShip",
+    [PROFILE_DRAW_GAME]    = "DrawGameFrame",
+    [PROFILE_DRAW_UI]      = "DrawUiFrame",
+    [PROFILE_END_DRAWING]  = "EndDrawing",
+    [PROFILE_JOB]          = "Job",
+};
+
+// Copy finished events out of the ring buffer, oldest first, returns count
+static unsigned int CopyProfileEvents(ProfileEvent *events)
+{
+    unsigned int end = AtomicLoad(&profileWriteIndex);
+    unsigned int start = (end > PROFILER_EVENT_CAPACITY)? end - PROFILER_EVENT_CAPACITY : 0;
+    unsigned int count = 0;
+    for (unsigned int i = start; i != end; i++)
+    {
+        // Skip events still being written, or overwritten while copying
+        ProfileEvent *event = &profileEvents[i & (PROFILER_EVENT_CAPACITY - 1)];
+        if (AtomicLoad(&event->sequence) != i + 1)
+            continue;
+        ProfileEvent copy = *event;
+        AtomicFenceAcquire(); // the copy is read before checking the sequence again
+        if (AtomicLoad(&event->sequence) != i + 1)
+            continue;
+        events[count++] = copy;
+    }
+
+    return count;
+}
+
+unsigned long long GetProfilerTicks(void)
+{
+#if defined(_WIN32)
+    static long long frequency = 0;
+    long long count = 0;
+    if (frequency == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&count);
+    return (unsigned long long)(count/frequency)*1000000000ull +
+           (unsigned long long)(count%frequency)*1000000000ull/(unsigned long long)frequency;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec*1000000000ull + (unsigned long long)now.tv_nsec;
+#endif
+}
+
+double GetProfilerTime(void)
+{
+    return (double)GetProfilerTicks()*1e-9;
+}
+
+void RecordProfileEvent(ProfileZone zone, bool isEnd)
+{
+    unsigned int index = AtomicFetchAdd(&profileWriteIndex, 1);
+    ProfileEvent *event = &profileEvents[index & (PROFILER_EVENT_CAPACITY - 1)];
+
+    AtomicStore(&event->sequence, 0); // readers skip it until it's written
+    AtomicFenceRelease(); // and see the 0 before any of the fields below change
+    event->time = GetProfilerTicks();
+    event->zone = (unsigned char)zone;
+    event->thread = (unsigned char)GetJobThreadIndex();
+    event->isEnd = isEnd;
+    AtomicStore(&event->sequence, index + 1);
+}
+
+const char *GetProfileZoneName(ProfileZone zone)
+{
+    return ((unsigned int)zone < PROFILE_ZONE_COUNT)? profileZoneNames[zone] : "Unknown";
+}
+
+void UpdateProfilerSnapshot(void)
+{
+    profileSnapshotCount = CopyProfileEvents(profileSnapshot);
+}
+
+unsigned int GetProfilerFrameTimes(float *frameTimes, unsigned int maxCount)
+{
+    unsigned int eventCount = profileSnapshotCount;
+    unsigned int frameCount = 0;
+    unsigned long long frameEnd = 0;
+
+    // Newest first, pair each frame end with the begin before it
+    for (unsigned int i = eventCount; (i > 0) && (frameCount < maxCount); i--)
+    {
+        ProfileEvent *event = &profileSnapshot[i - 1];
+        if ((event->zone != PROFILE_FRAME) || (event->thread != 0))
+            continue;
+        if (event->isEnd)
+            frameEnd = event->time;
+        else if (frameEnd != 0)
+        {
+            frameTimes[frameCount++] = (float)((double)(frameEnd - event->time)*1e-6);
+            frameEnd = 0;
+        }
+    }
+
+    return frameCount;
+}
+
+void GetProfilerZoneTimes(float *zoneTimes)
+{
+    unsigned int eventCount = profileSnapshotCount;
+    for (unsigned int zone = 0; zone < PROFILE_ZONE_COUNT; zone++)
+        zoneTimes[zone] = 0.0f;
+
+    // Find the last finished frame
+    unsigned int frameEnd = eventCount;
+    unsigned int frameBegin = eventCount;
+    for (unsigned int i = eventCount; i > 0; i--)
+    {
+        ProfileEvent *event = &profileSnapshot[i - 1];
+        if ((event->zone != PROFILE_FRAME) || (event->thread != 0))
+            continue;
+        if (event->isEnd && (frameEnd == eventCount))
+            frameEnd = i - 1;
+        else if (!event->isEnd && (frameEnd != eventCount))
+        {
+            frameBegin = i - 1;
+            break;
+        }
+    }
+    if (frameBegin == eventCount)
+        return;
+
+    // Add up each zone, a zone can run more than once a frame (e.g. game ticks)
+    unsigned long long zoneBegin[PROFILE_ZONE_COUNT] = { 0 };
+    for (unsigned int i = frameBegin; i <= frameEnd; i++)
+    {
+        ProfileEvent *event = &profileSnapshot[i];
+        if (event->thread != 0)
+            continue;
+        if (!event->isEnd)
+            zoneBegin[event->zone] = event->time;
+        else if (zoneBegin[event->zone] != 0)
+        {
+            zoneTimes[event->zone] += (float)((double)(event->time - zoneBegin[event->zone])*1e-6);
+            zoneBegin[event->zone] = 0;
+        }
+    }
+}
+
+bool SaveProfilerTrace(const char *fileName)
+{
+    FILE *file = fopen(fileName, "w");
+    if (file == NULL)
+    {
+        TraceLog(LOG_WARNING, "PROFILER: Failed to open trace file %s", fileName);
+        return false;
+    }
+
+    UpdateProfilerSnapshot();
+    unsigned int eventCount = profileSnapshotCount;
+    unsigned long long startTime = (eventCount > 0)? profileSnapshot[0].time : 0;
+    for (unsigned int i = 1; i < eventCount; i++)
+        if (profileSnapshot[i].time < startTime) startTime = profileSnapshot[i].time; // threads can record out of order
+    bool zoneOpen[JOB_MAX_THREADS][PROFILE_ZONE_COUNT] = { 0 };
+    bool firstEvent = true;
+
+    // Timestamps are in microseconds from the oldest event
+    fprintf(file, "{\"traceEvents\":[");
+    for (unsigned int i = 0; i < eventCount; i++)
+    {
+        ProfileEvent *event = &profileSnapshot[i];
+        if (event->isEnd && !zoneOpen[event->thread][event->zone])
+            continue; // its begin was already overwritten
+        zoneOpen[event->thread][event->zone] = !event->isEnd;
+
+        fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                firstEvent? "" : ",", GetProfileZoneName(event->zone), event->isEnd? 'E' : 'B',
+                (double)(event->time - startTime)*1e-3, event->thread + 1u);
+        firstEvent = false;
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    TraceLog(LOG_INFO, "PROFILER: Saved %u events to %s", eventCount, fileName);
+    return true;
+}
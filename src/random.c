@@ -0,0 +1,59 @@
+// EXPLANATION:
+// Random number streams
+// See random.h for more documentation/descriptions
+
+#include "random.h"
+
+#define PCG_MULTIPLIER 6364136223846793005ull
+
+// Random Streams
+// ----------------------------------------------------------------------------
+void SeedRandomStream(RandomStream *stream, unsigned long long seed, unsigned long long streamId)
+{
+    // Same seeding as the PCG reference (pcg32_srandom_r)
+    stream->state = 0;
+    stream->increment = (streamId << 1) | 1;
+    GetRandomBits(stream);
+    stream->state += seed;
+    GetRandomBits(stream);
+}
+
+unsigned int GetRandomBits(RandomStream *stream)
+{
+    // XSH RR: xorshift the high bits down, then rotate by the top 5 bits
+    unsigned long long oldState = stream->state;
+    stream->state = oldState*PCG_MULTIPLIER + stream->increment;
+    unsigned int xorShifted = (unsigned int)(((oldState >> 18) ^ oldState) >> 27);
+    unsigned int rotation = (unsigned int)(oldState >> 59);
+    return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+}
+
+int GetRandomInt(RandomStream *stream, int min, int max)
+{
+    if (min > max)
+    {
+        int swap = min;
+        min = max;
+        max = swap;
+    }
+
+    // Scale to the range with a 64 bit multiply, bias is too small to matter
+    // for ranges this game uses (and it's faster than retrying)
+    unsigned long long range = (unsigned long long)((long long)max - min) + 1;
+    unsigned long long scaled = ((unsigned long long)GetRandomBits(stream)*range) >> 32;
+    return (int)((long long)min + (long long)scaled);
+}
+
+float GetRandomFloat(RandomStream *stream)
+{
+    return (float)(GetRandomBits(stream) >> 8)*(1.0f/16777216.0f); // 24 bits fit a float exactly
+}
+
+unsigned long long MixRandomSeed(unsigned long long seed, unsigned long long value)
+{
+    // splitmix64 finalizer, so nearby seeds and values end up far apart
+    unsigned long long mixed = seed + 0x9E3779B97F4A7C15ull*(value + 1);
+    mixed = (mixed ^ (mixed >> 30))*0xBF58476D1CE4E5B9ull;
+    mixed = (mixed ^ (mixed >> 27))*0x94D049BB133111EBull;
+    return mixed ^ (mixed >> 31);
+}
@@ -0,0 +1,217 @@
+// EXPLANATION:
+// Render queue for the game world
+// See render.h for more documentation/descriptions
+
+#include "render.h"
+
+#include <stdlib.h> // for qsort
+
+#include "rlgl.h"
+#include "config.h"
+#include "drawstats.h"
+
+// Globals
+// ----------------------------------------------------------------------------
+static RenderCommand *renderCommands = NULL;
+static unsigned int renderCommandCount = 0;
+static unsigned int renderCommandCapacity = 0;
+static rlRenderBatch renderBatch = { 0 };
+static bool renderBatchLoaded = false;
+static Starfield starfield = { 0 };
+
+// Local Functions
+// ----------------------------------------------------------------------------
+
+// Layer in the top bits, then texture, type and queue order, so sorting keeps
+// the order things were queued in when everything else matches
+static unsigned long long GetRenderSortKey(RenderLayer layer, unsigned int textureId, RenderCommandType type)
+{
+    return ((unsigned long long)layer << 56) |
+           ((unsigned long long)(textureId & 0x3FFFFF) << 34) |
+           ((unsigned long long)type << 32) |
+           (unsigned long long)renderCommandCount;
+}
+
+static RenderCommand *AddRenderCommand(void)
+{
+    if (renderCommandCount == renderCommandCapacity)
+    {
+        renderCommandCapacity = (renderCommandCapacity > 0)? renderCommandCapacity*2 : 2048;
+        renderCommands = MemRealloc(renderCommands, renderCommandCapacity*sizeof(RenderCommand));
+    }
+
+    return &renderCommands[renderCommandCount++];
+}
+
+static int CompareRenderCommands(const void *a, const void *b)
+{
+    unsigned long long x = ((const RenderCommand *)a)->sortKey;
+    unsigned long long y = ((const RenderCommand *)b)->sortKey;
+    return (x > y) - (x < y);
+}
+
+// Render Queue
+// ----------------------------------------------------------------------------
+void InitRenderQueue(void)
+{
+    if (!IsWindowReady() || renderBatchLoaded)
+        return;
+
+    renderBatch = rlLoadRenderBatch(1, RENDER_BATCH_ELEMENTS);
+    renderBatchLoaded = true;
+}
+
+void FreeRenderQueue(void)
+{
+    if (renderBatchLoaded)
+        rlUnloadRenderBatch(renderBatch);
+    renderBatchLoaded = false;
+
+    if (starfield.texture.id > 0)
+        UnloadRenderTexture(starfield.texture);
+    starfield = (Starfield){ 0 };
+
+    MemFree(renderCommands);
+    renderCommands = NULL;
+    renderCommandCount = 0;
+    renderCommandCapacity = 0;
+}
+
+void QueueSprite(RenderLayer layer, Texture texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color color)
+{
+    unsigned long long sortKey = GetRenderSortKey(layer, texture.id, RENDER_SPRITE);
+    RenderCommand *command = AddRenderCommand();
+    command->sortKey = sortKey;
+    command->type = RENDER_SPRITE;
+    command->color = color;
+    command->texture = texture;
+    command->source = source;
+    command->dest = dest;
+    command->points[0] = origin;
+    command->value = rotation;
+}
+
+void QueueCircle(RenderLayer layer, Vector2 center, float radius, Color color)
+{
+    unsigned long long sortKey = GetRenderSortKey(layer, 0, RENDER_CIRCLE);
+    RenderCommand *command = AddRenderCommand();
+    command->sortKey = sortKey;
+    command->type = RENDER_CIRCLE;
+    command->color = color;
+    command->points[0] = center;
+    command->value = radius;
+}
+
+void QueueTriangle(RenderLayer layer, Vector2 v1, Vector2 v2, Vector2 v3, Color color)
+{
+    unsigned long long sortKey = GetRenderSortKey(layer, 0, RENDER_TRIANGLE);
+    RenderCommand *command = AddRenderCommand();
+    command->sortKey = sortKey;
+    command->type = RENDER_TRIANGLE;
+    command->color = color;
+    command->points[0] = v1;
+    command->points[1] = v2;
+    command->points[2] = v3;
+}
+
+void SetStarfield(const Vector2 *stars, unsigned int starCount)
+{
+    starfield.stars = stars;
+    starfield.starCount = starCount;
+    starfield.isBaked = false;
+}
+
+void UpdateStarfield(int width, int height)
+{
+    if (!IsWindowReady() || (width <= 0) || (height <= 0))
+        return;
+    if (starfield.isBaked && (width == starfield.texture.texture.width) && (height == starfield.texture.texture.height))
+        return;
+
+    starfield.isBaked = false; // until the new texture is drawn, in case it fails to load
+    if (starfield.texture.id > 0)
+        UnloadRenderTexture(starfield.texture);
+    starfield.texture = LoadRenderTexture(width, height);
+    if (starfield.texture.id == 0)
+        return; // stars are drawn one by one instead
+
+    // Stars at the same size they'd have on screen, so the texture is drawn 1:1
+    Camera2D camera = { .zoom = (float)width/VIRTUAL_WIDTH };
+    BeginTextureMode(starfield.texture);
+        ClearBackground(BLANK);
+        BeginMode2D(camera);
+            for (unsigned int i = 0; i < starfield.starCount; i++)
+                DrawCircleV(starfield.stars[i], 1.0f, WHITE);
+        EndMode2D();
+    EndTextureMode();
+    starfield.isBaked = true;
+}
+
+void QueueStarfield(Color tint)
+{
+    if (!starfield.isBaked)
+    {
+        for (unsigned int i = 0; i < starfield.starCount; i++)
+            QueueCircle(RENDER_LAYER_STARS, starfield.stars[i], 1.0f, tint);
+        return;
+    }
+
+    Texture texture = starfield.texture.texture;
+    Rectangle source = { 0, 0, (float)texture.width, -(float)texture.height }; // render textures are upside down
+    Rectangle dest = { 0, 0, VIRTUAL_WIDTH, VIRTUAL_HEIGHT };
+    QueueSprite(RENDER_LAYER_STARS, texture, source, dest, (Vector2){ 0 }, 0.0f, tint);
+}
+
+void DrawStarfield(Color tint)
+{
+    if (!starfield.isBaked)
+    {
+        for (unsigned int i = 0; i < starfield.starCount; i++)
+            DrawCircleV(starfield.stars[i], 1.0f, tint);
+        return;
+    }
+
+    Texture texture = starfield.texture.texture;
+    Rectangle source = { 0, 0, (float)texture.width, -(float)texture.height };
+    Rectangle dest = { 0, 0, VIRTUAL_WIDTH, VIRTUAL_HEIGHT };
+    DrawTexturePro(texture, source, dest, (Vector2){ 0 }, 0.0f, tint);
+}
+
+void DrawRenderQueue(void)
+{
+    qsort(renderCommands, renderCommandCount, sizeof(RenderCommand), CompareRenderCommands);
+
+    // raylib's draw functions add to whichever batch is active, and only start
+    // a new draw call when the texture or primitive type changes
+    if (renderBatchLoaded)
+    {
+        SetDrawStatsBatchSize(RENDER_BATCH_ELEMENTS);
+        rlSetRenderBatchActive(&renderBatch);
+    }
+
+    for (unsigned int i = 0; i < renderCommandCount; i++)
+    {
+        RenderCommand *command = &renderCommands[i];
+        switch (command->type)
+        {
+            case RENDER_SPRITE:
+                DrawTexturePro(command->texture, command->source, command->dest,
+                               command->points[0], command->value, command->color);
+                break;
+            case RENDER_CIRCLE:
+                DrawCircleV(command->points[0], command->value, command->color);
+                break;
+            case RENDER_TRIANGLE:
+                DrawTriangle(command->points[0], command->points[1], command->points[2], command->color);
+                break;
+        }
+    }
+
+    // Draws the rest of the batch, and goes back to raylib's batch for the UI
+    if (renderBatchLoaded)
+    {
+        SetDrawStatsBatchSize(RL_DEFAULT_BATCH_BUFFER_ELEMENTS);
+        rlSetRenderBatchActive(NULL);
+    }
+    renderCommandCount = 0;
+}
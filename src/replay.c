@@ -0,0 +1,321 @@
+// EXPLANATION:
+// Input recording and playback
+// See replay.h for more documentation/descriptions
+
+#include "replay.h"
+
+#include <string.h> // for memcpy, memcmp
+
+#include "config.h"
+#include "input.h"
+#include "game.h"
+
+#define REPLAY_MAGIC "ARPL"
+#define REPLAY_BUTTON_COUNT 25
+
+// Globals
+// ----------------------------------------------------------------------------
+static ReplayState replay = { 0 };
+
+// Local Functions
+// ----------------------------------------------------------------------------
+
+// Every bool a tick can read from the input state, in the order of their bits
+static void GetReplayButtons(bool **buttons)
+{
+    bool *list[REPLAY_BUTTON_COUNT] = {
+        &input.global.fullscreen, &input.global.debug, &input.global.saveTrace,
+        &input.menu.confirm, &input.menu.cancel, &input.menu.moveUp, &input.menu.moveDown,
+        &input.player.pause, &input.player.rotateLeft, &input.player.rotateRight,
+        &input.player.thrust, &input.player.shoot, &input.player.thrustMouse, &input.player.shootMouse,
+        &input.mouse.moved, &input.mouse.tapped, &input.mouse.leftPressed, &input.mouse.leftDown,
+        &input.mouse.rightPressed, &input.mouse.rightDown,
+        &input.anyKeyPressed, &input.anyGamepadButtonPressed, &input.anyInputPressed,
+        &input.touchMode, &input.gamepad.available,
+    };
+    memcpy(buttons, list, sizeof(list));
+}
+
+static void GetReplayValues(float **values)
+{
+    values[REPLAY_MOUSE_X] = &input.mouse.position.x;
+    values[REPLAY_MOUSE_Y] = &input.mouse.position.y;
+    values[REPLAY_MOUSE_DELTA_X] = &input.mouse.delta.x;
+    values[REPLAY_MOUSE_DELTA_Y] = &input.mouse.delta.y;
+    values[REPLAY_LEFT_STICK_X] = &input.gamepad.leftStickX;
+    values[REPLAY_LEFT_STICK_Y] = &input.gamepad.leftStickY;
+    values[REPLAY_RIGHT_STICK_X] = &input.gamepad.rightStickX;
+    values[REPLAY_RIGHT_STICK_Y] = &input.gamepad.rightStickY;
+    values[REPLAY_LEFT_TRIGGER] = &input.gamepad.leftTrigger;
+    values[REPLAY_RIGHT_TRIGGER] = &input.gamepad.rightTrigger;
+    values[REPLAY_FRAME_TIME] = &game.frameTime;
+}
+
+static unsigned int GetFloatBits(float value)
+{
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float GetBitsFloat(unsigned int bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// 7 bits per byte, low bits first, the top bit means another byte follows
+static void WriteVarint(unsigned int value)
+{
+    if (replay.size + 5 > replay.capacity)
+    {
+        replay.capacity = (replay.capacity > 0)? replay.capacity*2 : 4096;
+        replay.data = MemRealloc(replay.data, replay.capacity);
+    }
+
+    while (value >= 0x80)
+    {
+        replay.data[replay.size++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    replay.data[replay.size++] = (unsigned char)value;
+}
+
+static bool ReadVarint(unsigned int *value)
+{
+    *value = 0;
+    for (unsigned int shift = 0; shift < 35; shift += 7)
+    {
+        if (replay.readPosition >= replay.size)
+            return false;
+        unsigned char byte = replay.data[replay.readPosition++];
+        *value |= (unsigned int)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+
+    return false; // too long
+}
+
+// A change mask of 0 starts a run of unchanged ticks
+static void WriteReplayRun(void)
+{
+    if (replay.runLength == 0)
+        return;
+
+    WriteVarint(0);
+    WriteVarint(replay.runLength);
+    replay.runLength = 0;
+}
+
+static void SetReplayTickInput(ReplayTick *tick)
+{
+    bool *buttons[REPLAY_BUTTON_COUNT];
+    float *values[REPLAY_VALUE_COUNT];
+    GetReplayButtons(buttons);
+    GetReplayValues(values);
+
+    for (unsigned int i = 0; i < REPLAY_BUTTON_COUNT; i++)
+        *buttons[i] = (tick->buttons >> i) & 1;
+    for (unsigned int i = 0; i < REPLAY_VALUE_COUNT; i++)
+        *values[i] = tick->values[i];
+}
+
+// Replay
+// ----------------------------------------------------------------------------
+void EnableReplayRecording(const char *fileName)
+{
+    replay.recordSessions = true;
+    replay.fileName = fileName;
+}
+
+bool LoadReplay(const char *fileName)
+{
+    int fileSize = 0;
+    unsigned char *fileData = LoadFileData(fileName, &fileSize);
+    if (fileData == NULL)
+        return false;
+
+    // Read the header with the same functions as the ticks
+    FreeReplay();
+    replay.data = fileData;
+    replay.size = (unsigned int)fileSize;
+    replay.readPosition = 4;
+    unsigned int version = 0;
+    unsigned int tickRate = 0;
+    bool isValid = (fileSize >= 4) && (memcmp(fileData, REPLAY_MAGIC, 4) == 0) &&
+                   ReadVarint(&version) && (version == REPLAY_VERSION) &&
+                   ReadVarint(&tickRate) && (tickRate == TICK_RATE) &&
+                   ReadVarint(&replay.seed) && ReadVarint(&replay.tickCount);
+
+    // Ticks are read from a copy, so MemFree() works the same as for recordings
+    replay.data = NULL;
+    if (isValid)
+    {
+        replay.size = (unsigned int)fileSize - replay.readPosition;
+        replay.capacity = replay.size;
+        replay.data = MemAlloc(replay.size + 1);
+        memcpy(replay.data, fileData + replay.readPosition, replay.size);
+        replay.readPosition = 0;
+        replay.isPlaying = true;
+    }
+    else
+    {
+        TraceLog(LOG_WARNING, "REPLAY: [%s] Not a replay from this version of the game", fileName);
+        FreeReplay();
+    }
+    UnloadFileData(fileData);
+
+    return isValid;
+}
+
+void FreeReplay(void)
+{
+    MemFree(replay.data);
+    bool recordSessions = replay.recordSessions;
+    const char *fileName = replay.fileName;
+    replay = (ReplayState){ .recordSessions = recordSessions, .fileName = fileName };
+}
+
+void StartReplaySession(void)
+{
+    if (replay.isPlaying)
+    {
+        SetGameSeed(replay.seed);
+        return;
+    }
+    if (!replay.recordSessions)
+        return;
+
+    replay.size = 0;
+    replay.tickCount = 0;
+    replay.runLength = 0;
+    replay.seed = game.seed;
+    replay.previous = (ReplayTick){ 0 };
+    replay.isRecording = true;
+}
+
+void EndReplaySession(void)
+{
+    if (!replay.isRecording)
+        return;
+    replay.isRecording = false;
+    WriteReplayRun();
+
+    // Header in front of the ticks
+    unsigned int tickSize = replay.size;
+    WriteVarint(REPLAY_VERSION);
+    WriteVarint(TICK_RATE);
+    WriteVarint(replay.seed);
+    WriteVarint(replay.tickCount);
+    unsigned int headerSize = replay.size - tickSize;
+
+    unsigned int fileSize = 4 + replay.size;
+    unsigned char *fileData = MemAlloc(fileSize);
+    memcpy(fileData, REPLAY_MAGIC, 4);
+    memcpy(fileData + 4, replay.data + tickSize, headerSize);
+    memcpy(fileData + 4 + headerSize, replay.data, tickSize);
+    SaveFileData(replay.fileName, fileData, (int)fileSize);
+    MemFree(fileData);
+    replay.size = 0;
+}
+
+void RecordReplayTick(void)
+{
+    if (!replay.isRecording)
+        return;
+
+    bool *buttons[REPLAY_BUTTON_COUNT];
+    float *values[REPLAY_VALUE_COUNT];
+    GetReplayButtons(buttons);
+    GetReplayValues(values);
+
+    ReplayTick tick = { 0 };
+    for (unsigned int i = 0; i < REPLAY_BUTTON_COUNT; i++)
+        tick.buttons |= (unsigned int)*buttons[i] << i;
+    for (unsigned int i = 0; i < REPLAY_VALUE_COUNT; i++)
+        tick.values[i] = *values[i];
+
+    // Bit 0 is the buttons, then one bit per value, compared bit for bit
+    unsigned int changed = (tick.buttons != replay.previous.buttons)? 1 : 0;
+    for (unsigned int i = 0; i < REPLAY_VALUE_COUNT; i++)
+    {
+        if (GetFloatBits(tick.values[i]) != GetFloatBits(replay.previous.values[i]))
+            changed |= 2u << i;
+    }
+    replay.tickCount++;
+
+    if (changed == 0)
+    {
+        replay.runLength++;
+        return;
+    }
+
+    WriteReplayRun();
+    WriteVarint(changed);
+    if (changed & 1)
+        WriteVarint(tick.buttons);
+    for (unsigned int i = 0; i < REPLAY_VALUE_COUNT; i++)
+    {
+        // Only the bits that changed, so small changes stay short
+        if (changed & (2u << i))
+            WriteVarint(GetFloatBits(tick.values[i]) ^ GetFloatBits(replay.previous.values[i]));
+    }
+    replay.previous = tick;
+}
+
+bool PlayReplayTick(void)
+{
+    if (!replay.isPlaying || (replay.tickCount == 0))
+        return false;
+
+    if (replay.runLength > 0)
+        replay.runLength--;
+    else
+    {
+        unsigned int changed = 0;
+        bool isValid = ReadVarint(&changed);
+        if (isValid && (changed == 0))
+        {
+            unsigned int runLength = 0;
+            isValid = ReadVarint(&runLength) && (runLength > 0);
+            if (isValid)
+                replay.runLength = runLength - 1; // this tick is the first of the run
+        }
+        else if (isValid)
+        {
+            if (changed & 1)
+                isValid = ReadVarint(&replay.previous.buttons);
+            for (unsigned int i = 0; isValid && (i < REPLAY_VALUE_COUNT); i++)
+            {
+                unsigned int bits = 0;
+                if (!(changed & (2u << i)))
+                    continue;
+                isValid = ReadVarint(&bits);
+                replay.previous.values[i] = GetBitsFloat(GetFloatBits(replay.previous.values[i]) ^ bits);
+            }
+        }
+
+        if (!isValid)
+        {
+            TraceLog(LOG_WARNING, "REPLAY: Replay data ends early, %u ticks left", replay.tickCount);
+            replay.isPlaying = false;
+            return false;
+        }
+    }
+
+    SetReplayTickInput(&replay.previous);
+    replay.tickCount--;
+    return true;
+}
+
+bool IsReplayPlaying(void)
+{
+    return replay.isPlaying;
+}
+
+unsigned int GetReplayTickCount(void)
+{
+    return replay.tickCount;
+}
@@ -0,0 +1,117 @@
+// EXPLANATION:
+// Asset packer, run at build time (the `pack` target of the Makefile or CMake)
+// Decodes every PNG and WAV in assets/ and writes them into one assets.pak,
+// so the game maps a single file and skips decoding (see assetpack.h)
+// - Run it from the game's directory, assets are found by the path they're
+//   packed under (e.g. "assets/ship.png")
+// - Usage: asteroids_packer [asset directory] [pack file]
+
+#include "raylib.h"
+
+#include <stdlib.h> // for qsort
+#include <string.h> // for memcpy, strcmp, strlen
+
+#include "assetpack.h"
+
+// Local Functions
+// ----------------------------------------------------------------------------
+
+// Sorted by name, so the same files always make the same pack
+static int CompareFileNames(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static unsigned int AlignPackOffset(unsigned int offset)
+{
+    return (offset + ASSET_PACK_ALIGNMENT - 1)/ASSET_PACK_ALIGNMENT*ASSET_PACK_ALIGNMENT;
+}
+
+// Main entry point
+// ----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    const char *directory = (argc > 1)? argv[1] : "assets";
+    const char *packFileName = (argc > 2)? argv[2] : ASSET_PACK_FILE;
+
+    FilePathList files = LoadDirectoryFilesEx(directory, ".png;.wav", false);
+    qsort(files.paths, files.count, sizeof(char *), CompareFileNames);
+
+    // Decode everything first, to know where each asset's data goes
+    AssetPackEntry *entries = MemAlloc((files.count + 1)*sizeof(AssetPackEntry));
+    Image *images = MemAlloc((files.count + 1)*sizeof(Image));
+    Wave *waves = MemAlloc((files.count + 1)*sizeof(Wave));
+    unsigned int entryCount = 0;
+    unsigned int packSize = sizeof(AssetPackHeader) + files.count*sizeof(AssetPackEntry);
+    for (unsigned int i = 0; i < files.count; i++)
+    {
+        const char *fileName = files.paths[i];
+        if (strlen(fileName) >= ASSET_PACK_NAME_SIZE)
+        {
+            TraceLog(LOG_WARNING, "PACKER: [%s] Path too long to pack, skipped", fileName);
+            continue;
+        }
+
+        AssetPackEntry entry = { 0 };
+        memcpy(entry.fileName, fileName, strlen(fileName) + 1);
+        if (IsFileExtension(fileName, ".png"))
+        {
+            Image image = LoadImage(fileName);
+            if (!IsImageValid(image))
+                continue;
+            ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            entry.type = ASSET_PACK_TEXTURE;
+            entry.width = (unsigned int)image.width;
+            entry.height = (unsigned int)image.height;
+            entry.size = entry.width*entry.height*4;
+            images[entryCount] = image;
+        }
+        else
+        {
+            Wave wave = LoadWave(fileName);
+            if (!IsWaveValid(wave))
+                continue;
+            WaveFormat(&wave, ASSET_PACK_SAMPLE_RATE, ASSET_PACK_SAMPLE_SIZE, ASSET_PACK_CHANNELS);
+            entry.type = ASSET_PACK_SOUND;
+            entry.frameCount = wave.frameCount;
+            entry.size = wave.frameCount*ASSET_PACK_CHANNELS*ASSET_PACK_SAMPLE_SIZE/8;
+            waves[entryCount] = wave;
+        }
+
+        packSize = AlignPackOffset(packSize);
+        entry.offset = packSize;
+        packSize += entry.size;
+        entries[entryCount++] = entry;
+    }
+
+    // Write the pack, skipped files leave unused entry space before the data
+    unsigned char *pack = MemAlloc(packSize); // zeroed, so padding is too
+    AssetPackHeader header = { .version = ASSET_PACK_VERSION, .entryCount = entryCount };
+    memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic));
+    memcpy(pack, &header, sizeof(header));
+    memcpy(pack + sizeof(header), entries, entryCount*sizeof(AssetPackEntry));
+    for (unsigned int i = 0; i < entryCount; i++)
+    {
+        if (entries[i].type == ASSET_PACK_TEXTURE)
+        {
+            memcpy(pack + entries[i].offset, images[i].data, entries[i].size);
+            UnloadImage(images[i]);
+        }
+        else
+        {
+            memcpy(pack + entries[i].offset, waves[i].data, entries[i].size);
+            UnloadWave(waves[i]);
+        }
+    }
+    bool isSaved = SaveFileData(packFileName, pack, (int)packSize);
+    if (isSaved)
+        TraceLog(LOG_INFO, "PACKER: [%s] Packed %u assets, %u bytes", packFileName, entryCount, packSize);
+
+    MemFree(pack);
+    MemFree(waves);
+    MemFree(images);
+    MemFree(entries);
+    UnloadDirectoryFiles(files);
+
+    return isSaved? 0 : 1;
+}
@@ -4,12 +4,19 @@
 
 #include "ui.h"
 
+#include <stdio.h> // for snprintf of cached text
+
 #include "raylib.h"
 #include "raymath.h"
 
 #include "config.h"
+#include "assets.h"
 #include "input.h"
 #include "game.h"
+#include "profiler.h"
+#include "render.h"
+#include "drawstats.h"
+#include "replay.h"
 
 #define ARRAY_SIZE(arr) (sizeof(arr)/sizeof((arr)[0]))
 
@@ -66,13 +73,11 @@ void InitUiState(void)
     float flyPosX = VIRTUAL_WIDTH - UI_INPUT_RADIUS - touchInputPadding;
     float flyPosY = VIRTUAL_HEIGHT - UI_INPUT_RADIUS - touchInputPadding*1.75f;
     defaults.gamepad.fly = InitUiInputButton("Thrust", INPUT_ACTION_THRUST, flyPosX, flyPosY, UI_INPUT_RADIUS);
-    defaults.gamepad.fly.icon = LoadTexture("assets/icon_button_a.png");
 
     // Shoot button
     float shootPosX = VIRTUAL_WIDTH - UI_INPUT_RADIUS - touchInputPadding*2;
     float shootPosY = VIRTUAL_HEIGHT - UI_INPUT_RADIUS - touchInputPadding;
     defaults.gamepad.shoot = InitUiInputButton("Shoot", INPUT_ACTION_SHOOT, shootPosX, shootPosY, UI_INPUT_RADIUS);
-    defaults.gamepad.shoot.icon = LoadTexture("assets/icon_button_x.png");
 
     // Analog stick
     UiAnalogStick stick = { 0 };
@@ -88,10 +93,14 @@ void InitUiState(void)
     float pausePosX = (stick.centerPos.x + shootPosX)/2;
     float pausePosY = VIRTUAL_HEIGHT - UI_STICK_RADIUS - touchInputPadding;
     defaults.gamepad.pause = InitUiInputButton("Pause", INPUT_ACTION_PAUSE, pausePosX, pausePosY, UI_INPUT_RADIUS*0.75f);
-    defaults.gamepad.pause.icon = LoadTexture("assets/icon_pause.png");
     defaults.gamepad.pause.iconScale *= 0.75f;
 
     ui = defaults;
+
+    // Icons load in the background, into the buttons in ui (see assets.h)
+    QueueGameTexture(&ui.gamepad.fly.icon, "assets/icon_button_a.png");
+    QueueGameTexture(&ui.gamepad.shoot.icon, "assets/icon_button_x.png");
+    QueueGameTexture(&ui.gamepad.pause.icon, "assets/icon_pause.png");
 }
 
 UiButton InitUiTitle(char *text, bool nextLine)
@@ -114,8 +123,14 @@ UiButton InitUiTitle(char *text, bool nextLine)
 
 UiButton InitUiButton(char *text, int buttonId, float textPosX, float textPosY, int fontSize)
 {
+    // Buttons don't move, so the text is measured once here
+    float textWidth = (float)MeasureText(text, fontSize);
     UiButton button = {
         .text = text,
+        .bounds = {
+            textPosX - UI_BUTTON_THICKNESS, textPosY - UI_BUTTON_THICKNESS,
+            textWidth + UI_BUTTON_THICKNESS*2, (float)fontSize + UI_BUTTON_THICKNESS*2
+        },
         .buttonId = buttonId,
         .fontSize = fontSize,
         .position = { textPosX, textPosY },
@@ -152,7 +167,7 @@ UiButton *CreateUiMenuButton(char *text, UiMenu *menu, float textPosX, float tex
 UiButton *CreateUiMenuButtonRelative(char* text, UiMenu *menu, float offsetY, int fontSize)
 {
     UiButton *originButton = &menu->buttons[menu->buttonCount - 1];
-    float originWidth = (float)MeasureText(originButton->text, originButton->fontSize);
+    float originWidth = originButton->bounds.width - UI_BUTTON_THICKNESS*2;
     float originPosX = (originButton->position.x + originWidth/2);
     float textPosX = originPosX - MeasureText(text, fontSize)/2;
     float textPosY = originButton->position.y + originButton->fontSize;
@@ -165,9 +180,21 @@ void FreeUiState(void)
     for (unsigned int i = 0; i < ARRAY_SIZE(ui.menus); i++)
         MemFree(ui.menus[i].buttons);
 
-    UnloadTexture(ui.gamepad.fly.icon);
-    UnloadTexture(ui.gamepad.shoot.icon);
-    UnloadTexture(ui.gamepad.pause.icon);
+    UnloadGameTexture(ui.gamepad.fly.icon);
+    UnloadGameTexture(ui.gamepad.shoot.icon);
+    UnloadGameTexture(ui.gamepad.pause.icon);
+}
+
+void UpdateUiText(UiText *text, const char *format, int value, int fontSize)
+{
+    if ((format == text->format) && (value == text->value) && (fontSize == text->fontSize))
+        return;
+
+    text->format = format;
+    text->value = value;
+    text->fontSize = fontSize;
+    snprintf(text->text, UI_TEXT_LENGTH, format, value);
+    text->width = MeasureText(text->text, fontSize);
 }
 
 // Update / User Input
@@ -187,7 +214,7 @@ void UpdateUiFrame(void)
             ui.currentMenu != UI_MENU_PAUSE)
         {
             ChangeUiMenu(UI_MENU_TITLE);
-            PlaySound(game.sounds.menu);
+            PlayGameSound(assets.sounds.menu);
         }
 
         // Input for menu selection and movement
@@ -281,7 +308,7 @@ void UpdateUiMenuTraverse(void)
 
     // Play sound when cursor moved
     if (ui.selectedId != prevId && !ui.firstFrame && !input.touchMode)
-        PlaySound(game.sounds.menu);
+        PlayGameSound(assets.sounds.menu);
 
     ui.firstFrame = false;
 }
@@ -301,7 +328,7 @@ void UpdateUiButtonSelect(UiButton *button)
     //     if (button->buttonId == UI_BID_PAUSE)
     //     {
     //         ChangeUiMenu(UI_MENU_PAUSE);
-    //         PlaySound(game.sounds.menu);
+    //         PlayGameSound(assets.sounds.menu);
     //         button->clicked = true;
     //     }
     // }
@@ -340,7 +367,7 @@ void UpdateUiButtonSelect(UiButton *button)
                 ChangeUiMenu(UI_MENU_NONE);
         }
 
-        PlaySound(game.sounds.menu);
+        PlayGameSound(assets.sounds.menu);
     }
 }
 
@@ -407,7 +434,10 @@ void ChangeUiMenu(UiMenuState newMenu)
     {
         // Reset game state if returning from gameplay
         if (game.currentScreen == SCREEN_GAMEPLAY)
+        {
+            EndReplaySession();
             InitGameState(SCREEN_TITLE);
+        }
 
         ui.selectedId = UI_BID_START;
     }
@@ -423,6 +453,12 @@ void ChangeUiMenu(UiMenuState newMenu)
 
     else if (newMenu == UI_MENU_NONE)
     {
+        // New session from the title (seeds the first level's rocks), not resuming from pause
+        if (game.currentScreen != SCREEN_GAMEPLAY)
+        {
+            SetGameSeed(GetNextGameSeed());
+            StartReplaySession();
+        }
         game.currentScreen = SCREEN_GAMEPLAY;
         InitNewLevel(game.currentLevel);
     }
@@ -433,29 +469,12 @@ void ChangeUiMenu(UiMenuState newMenu)
 
 bool IsMouseWithinUiButton(UiButton *button)
 {
-    Vector2 mousePos = input.mouse.position;
-
-    int padding = UI_BUTTON_THICKNESS; // extra clickable area around the text
-    int buttonWidth = MeasureText(button->text, button->fontSize);
-    if ((mousePos.x >= button->position.x - padding) &&
-        (mousePos.x <= button->position.x + buttonWidth + padding) &&
-        (mousePos.y >= button->position.y - padding) &&
-        (mousePos.y <= button->position.y + button->fontSize + padding))
-        return true;
-    else
-        return false;
+    return CheckCollisionPointRec(input.mouse.position, button->bounds);
 }
 
 int IsTouchWithinUiButton(UiButton *button)
 {
-    int buttonWidth = MeasureText(button->text, button->fontSize);
-    Rectangle buttonRect = {
-       (float)button->position.x - UI_BUTTON_THICKNESS,
-       (float)button->position.y,
-       (float)buttonWidth + UI_BUTTON_THICKNESS*2,
-       (float)button->fontSize + UI_BUTTON_THICKNESS*2, };
-
-    return CheckCollisionTouchRec(buttonRect);
+    return CheckCollisionTouchRec(button->bounds);
 }
 
 // Draw
@@ -468,8 +487,7 @@ void DrawUiFrame(void)
     if (game.currentScreen == SCREEN_TITLE)
     {
         // Draw stars
-        for (unsigned int i = 0; i < STAR_AMOUNT; i++)
-            DrawCircleV(game.stars[i], 1.0f, RAYWHITE);
+        DrawStarfield(RAYWHITE);
 
         // Draw title text
         for (unsigned int i = 0; i < ARRAY_SIZE(ui.title); i++)
@@ -478,9 +496,9 @@ void DrawUiFrame(void)
 
     if (game.isPaused)
     {
-        char *text = "PAUSED";
-        int textOffset = MeasureText(text, UI_FONT_SIZE_CENTER)/2;
-        DrawText(text, VIRTUAL_WIDTH/2 - textOffset,
+        UiText *text = &ui.hud.paused;
+        UpdateUiText(text, "PAUSED", 0, UI_FONT_SIZE_CENTER);
+        DrawText(text->text, VIRTUAL_WIDTH/2 - text->width/2,
                  VIRTUAL_HEIGHT/3 - UI_FONT_SIZE_CENTER/2,
                  UI_FONT_SIZE_CENTER, Fade(RAYWHITE, ui.textFade));
     }
@@ -511,20 +529,20 @@ void DrawUiFrame(void)
         DrawLives();
 
         // Draw level indicator
-        const char *levelText = TextFormat("Level %i", game.currentLevel);
-        int textLength = MeasureText(levelText, UI_FONT_SIZE_EDGE);
-        DrawText(levelText,
-                 VIRTUAL_WIDTH - textLength - UI_EDGE_PADDING, UI_EDGE_PADDING,
+        UiText *levelText = &ui.hud.level;
+        UpdateUiText(levelText, "Level %i", (int)game.currentLevel, UI_FONT_SIZE_EDGE);
+        DrawText(levelText->text,
+                 VIRTUAL_WIDTH - levelText->width - UI_EDGE_PADDING, UI_EDGE_PADDING,
                  UI_FONT_SIZE_EDGE, RAYWHITE);
 
         // 10 asteroids or less text
         unsigned int totalRocksRemaining = game.rockLimit - game.eliminatedCount;
         if (totalRocksRemaining <= 10)
         {
-            const char* remainText = TextFormat("Remaining: %i", totalRocksRemaining);
-            int textOffset = MeasureText(remainText, UI_FONT_SIZE_EDGE)/2;
-            DrawText(remainText,
-                     VIRTUAL_WIDTH/2 - textOffset, UI_EDGE_PADDING,
+            UiText *remainText = &ui.hud.remaining;
+            UpdateUiText(remainText, "Remaining: %i", (int)totalRocksRemaining, UI_FONT_SIZE_EDGE);
+            DrawText(remainText->text,
+                     VIRTUAL_WIDTH/2 - remainText->width/2, UI_EDGE_PADDING,
                      UI_FONT_SIZE_EDGE, RAYWHITE);
         }
 
@@ -558,14 +576,11 @@ void DrawUiCursor(UiButton *selectedButton)
 
 void DrawUiOutline(UiButton *selectedButton)
 {
-    int padding         = UI_BUTTON_THICKNESS;
     int outlineWidth    = 4;
-    int buttonWidth     = MeasureText(selectedButton->text, selectedButton->fontSize);
-    int buttonHeight    = selectedButton->fontSize;
-    float buttonPosX    = selectedButton->position.x - padding;
-    float buttonPosY    = selectedButton->position.y - padding;
-    int highlightWidth  = buttonWidth + padding * 2;
-    int highlightHeight = buttonHeight + padding * 2;
+    float buttonPosX    = selectedButton->bounds.x;
+    float buttonPosY    = selectedButton->bounds.y;
+    int highlightWidth  = (int)selectedButton->bounds.width;
+    int highlightHeight = (int)selectedButton->bounds.height;
 
     Color boxColor = RAYWHITE;
     if (selectedButton->clicked)
@@ -611,11 +626,12 @@ void DrawUiAnalogStick(UiAnalogStick *stick)
 
 void DrawLives(void)
 {
-    const char* text = "Lives: ";
-    const int textWidth = MeasureText(text, UI_FONT_SIZE_EDGE);
-    DrawText(text, UI_EDGE_PADDING, UI_EDGE_PADDING, UI_FONT_SIZE_EDGE, RAYWHITE);
-    const float scale = UI_FONT_SIZE_EDGE*0.95f/game.ship.length;
-    const float spacing = game.ship.width*scale/8;
+    UiText *text = &ui.hud.lives;
+    UpdateUiText(text, "Lives: ", 0, UI_FONT_SIZE_EDGE);
+    const int textWidth = text->width;
+    DrawText(text->text, UI_EDGE_PADDING, UI_EDGE_PADDING, UI_FONT_SIZE_EDGE, RAYWHITE);
+    const float scale = UI_FONT_SIZE_EDGE*0.95f/SHIP_LENGTH;
+    const float spacing = SHIP_WIDTH*scale/8;
     Vector2 lifeTriangle[3] = { 0 };
 
     for (unsigned int i = 0; i < 3; i++)
@@ -623,15 +639,15 @@ void DrawLives(void)
         lifeTriangle[i] = Vector2Scale(game.shipTriangle[i], scale);
         lifeTriangle[i] = Vector2Rotate(lifeTriangle[i], DEG2RAD*30.0f);
         lifeTriangle[i].x += textWidth;
-        lifeTriangle[i].x += UI_EDGE_PADDING - game.ship.width*scale/2 - spacing;
-        lifeTriangle[i].y += UI_EDGE_PADDING + game.ship.length*scale/2;
+        lifeTriangle[i].x += UI_EDGE_PADDING - SHIP_WIDTH*scale/2 - spacing;
+        lifeTriangle[i].y += UI_EDGE_PADDING + SHIP_LENGTH*scale/2;
     }
 
     for (unsigned int i = 0; i < game.lives; i++)
     {
         for (unsigned int j = 0; j < 3; j++)
         {
-            lifeTriangle[j].x += spacing + game.ship.width*scale;
+            lifeTriangle[j].x += spacing + SHIP_WIDTH*scale;
         }
         DrawTriangle(lifeTriangle[0], lifeTriangle[1], lifeTriangle[2], RAYWHITE);
     }
@@ -640,7 +656,8 @@ void DrawLives(void)
 void DrawCenterText(void)
 {
     bool centerText = false;
-    const char *text;
+    const char *format = NULL; // formatted with value
+    int value = 0;
     Color fadeColor = Fade(RAYWHITE, ui.textFade);
 
     if (game.isPaused)
@@ -649,30 +666,32 @@ void DrawCenterText(void)
     }
     else if (game.lives <= 0)
     {
-        text = "GAME OVER";
+        format = "GAME OVER";
         centerText = true;
     }
     else if (game.levelFinished)
     {
-        text = "ASTEROIDS CLEARED";
+        format = "ASTEROIDS CLEARED";
         centerText = true;
     }
     else if (game.newLevelTimer > EPSILON)
     {
         if (game.currentLevel == 1)
-            text = "GAME START";
+            format = "GAME START";
         else
-            text = TextFormat("LEVEL %i", game.currentLevel);
+            format = "LEVEL %i";
+        value = (int)game.currentLevel;
         centerText = true;
     }
     else if (game.ship.isExploded)
     {
         if (game.ship.respawnTimer < SHIP_RESPAWN_TIME)
-            text = "RESPAWNING...";
+            format = "RESPAWNING...";
         else if (game.lives == 1)
-            text = TextFormat("%i LIFE LEFT!", game.lives);
+            format = "%i LIFE LEFT!";
         else
-            text = TextFormat("%i LIVES LEFT", game.lives);
+            format = "%i LIVES LEFT";
+        value = (int)game.lives;
         centerText = true;
     }
 
@@ -684,8 +703,9 @@ void DrawCenterText(void)
 
     if (centerText)
     {
-        int textOffset = MeasureText(text, UI_FONT_SIZE_CENTER)/2;
-        DrawText(text, VIRTUAL_WIDTH/2 - textOffset,
+        UiText *text = &ui.hud.center;
+        UpdateUiText(text, format, value, UI_FONT_SIZE_CENTER);
+        DrawText(text->text, VIRTUAL_WIDTH/2 - text->width/2,
                  VIRTUAL_HEIGHT/2 - UI_FONT_SIZE_CENTER/2,
                  UI_FONT_SIZE_CENTER, fadeColor);
     }
@@ -724,6 +744,56 @@ void DrawDebugInfo(void)
     textY += textSize;
     DrawText(TextFormat("%2i remaining", game.rockLimit - game.eliminatedCount), 0, textY, textSize, RAYWHITE);
     textY += textSize;
+    DrawText(TextFormat("%2i live / %i pool", game.rockCount, world.rockCapacity), 0, textY, textSize, RAYWHITE);
+    textY += textSize;
     DrawText(TextFormat("speed: %3.0f", Vector2Length(game.ship.velocity)), 0, textY, textSize, RAYWHITE);
     textY += textSize;
+
+    // Last frame, then the average for this screen
+    DrawStats frameStats = GetDrawStats();
+    DrawStats screenStats = GetScreenDrawStats(game.currentScreen);
+    DrawText(TextFormat("draws: %u (avg %u)  flushes: %u (avg %u)", frameStats.drawCalls, screenStats.drawCalls,
+                        frameStats.batchFlushes, screenStats.batchFlushes), 0, textY, textSize, RAYWHITE);
+    textY += textSize;
+    DrawText(TextFormat("verts: %u (avg %u)  textures: %u (avg %u)", frameStats.vertices, screenStats.vertices,
+                        frameStats.textureChanges, screenStats.textureChanges), 0, textY, textSize, RAYWHITE);
+    textY += textSize;
+
+    DrawProfilerInfo();
+}
+
+void DrawProfilerInfo(void)
+{
+    const int barWidth = 3;
+    const int graphHeight = 200;
+    const float graphMaxTime = 33.3f; // ms at the top of the graph
+    const int graphX = 0;
+    const int graphY = VIRTUAL_HEIGHT - graphHeight;
+    const int textSize = 30;
+    const float budget = 1000.0f/((MAX_FRAMERATE > 0)? MAX_FRAMERATE : 60);
+
+    UpdateProfilerSnapshot(); // one copy of the events for both the graph and the zones
+
+    // Frame time graph, newest frame on the right
+    float frameTimes[UI_PROFILER_GRAPH_FRAMES];
+    unsigned int frameCount = GetProfilerFrameTimes(frameTimes, UI_PROFILER_GRAPH_FRAMES);
+    DrawRectangle(graphX, graphY, UI_PROFILER_GRAPH_FRAMES*barWidth, graphHeight, Fade(BLACK, 0.6f));
+    for (unsigned int i = 0; i < frameCount; i++)
+    {
+        int barHeight = (int)(fminf(frameTimes[i]/graphMaxTime, 1.0f)*graphHeight);
+        int barX = graphX + (UI_PROFILER_GRAPH_FRAMES - 1 - i)*barWidth;
+        DrawRectangle(barX, graphY + graphHeight - barHeight, barWidth, barHeight, (frameTimes[i] > budget)? RED : GREEN);
+    }
+    int budgetY = graphY + graphHeight - (int)(budget/graphMaxTime*graphHeight);
+    DrawLine(graphX, budgetY, graphX + UI_PROFILER_GRAPH_FRAMES*barWidth, budgetY, YELLOW);
+
+    // Time spent in each zone during the last frame
+    float zoneTimes[PROFILE_ZONE_COUNT];
+    GetProfilerZoneTimes(zoneTimes);
+    int textY = graphY - PROFILE_ZONE_COUNT*textSize;
+    for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++)
+    {
+        DrawText(TextFormat("%6.2f ms %s", zoneTimes[zone], GetProfileZoneName((ProfileZone)zone)), graphX, textY, textSize, RAYWHITE);
+        textY += textSize;
+    }
 }